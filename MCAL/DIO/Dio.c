@@ -0,0 +1,136 @@
+//############# Dio.c ##############
+#include "Dio.h"
+#include "../../Service/BitMath.h"
+#include "../Interrupt/Interrupt.h"
+
+void DIO_init(uint8_t pinNumber, uint8_t port, uint8_t direction)
+{
+	//the SW UART ISR changes other pins of the same port, so it must not come between the read and the write
+	uint8_t sreg = SREG;
+	cli();
+	switch(port)
+	{
+		case A:
+			if(direction == OUT)
+			{
+				setBit(DDRA,pinNumber);
+			}
+			else
+			{
+				clrBit(DDRA,pinNumber);
+			}
+			break;
+		case B:
+			if(direction == OUT)
+			{
+				setBit(DDRB,pinNumber);
+			}
+			else
+			{
+				clrBit(DDRB,pinNumber);
+			}
+			break;
+		case C:
+			if(direction == OUT)
+			{
+				setBit(DDRC,pinNumber);
+			}
+			else
+			{
+				clrBit(DDRC,pinNumber);
+			}
+			break;
+		case D:
+			if(direction == OUT)
+			{
+				setBit(DDRD,pinNumber);
+			}
+			else
+			{
+				clrBit(DDRD,pinNumber);
+			}
+			break;
+		default:
+			break;
+	}
+	SREG = sreg;
+}
+
+
+void DIO_write(uint8_t pinNumber, uint8_t port, uint8_t value)
+{
+	//as in DIO_init, no ISR may come between the read and the write of the port
+	uint8_t sreg = SREG;
+	cli();
+	switch(port)
+	{
+		case A:
+			if(value == HIGH)
+			{
+				setBit(PORTA,pinNumber);
+			}
+			else
+			{
+				clrBit(PORTA,pinNumber);
+			}
+			break;
+		case B:
+			if(value == HIGH)
+			{
+				setBit(PORTB,pinNumber);
+			}
+			else
+			{
+				clrBit(PORTB,pinNumber);
+			}
+			break;
+		case C:
+			if(value == HIGH)
+			{
+				setBit(PORTC,pinNumber);
+			}
+			else
+			{
+				clrBit(PORTC,pinNumber);
+			}
+			break;
+		case D:
+			if(value == HIGH)
+			{
+				setBit(PORTD,pinNumber);
+			}
+			else
+			{
+				clrBit(PORTD,pinNumber);
+			}
+			break;
+		default:
+			break;
+	}
+	SREG = sreg;
+}
+
+
+void DIO_read(uint8_t pinNumber, uint8_t port, uint8_t *value)
+{
+	switch(port)
+	{
+		case A:
+			*value = getBit(PINA,pinNumber);
+			break;
+		case B:
+			*value = getBit(PINB,pinNumber);
+			break;
+		case C:
+			*value = getBit(PINC,pinNumber);
+			break;
+		case D:
+			*value = getBit(PIND,pinNumber);
+			break;
+		default:
+			break;
+	}
+}
+
+
+//////////////////////////////////////////////////////////
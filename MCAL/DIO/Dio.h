@@ -8,6 +8,8 @@
 #ifndef DIO_H_
 #define DIO_H_
 
+#include "../../Service/dataTypes.h"
+#include "../../Service/ATmega32Port.h"
 
 #define IN 0
 #define OUT 1
@@ -18,6 +20,7 @@
  * pinNumber: is an input argument that describes pin number in each port, 0, 1, 2, ... etc.
  * port: is an input argument that describes port character, 'A', 'B', ... etc.
  * direction: is an input argument that describes the data direction on a specific pin, IN or OUT
+ * The register is changed with the interrupts disabled, so the pins an ISR changes on the same port are kept.
  */
  void DIO_init(uint8_t pinNumber, uint8_t port, uint8_t direction);
  
@@ -25,6 +28,7 @@
  * pinNumber: is an input argument that describes pin number in each port, 0, 1, 2, ... etc.
  * port: is an input argument that describes port character, 'A', 'B', ... etc.
  * value: is an input argument that describes the value on a specific pin, LOW or HIGH
+ * The register is changed with the interrupts disabled, so the pins an ISR changes on the same port are kept.
  */
  void DIO_write(uint8_t pinNumber, uint8_t port, uint8_t value);
 
@@ -35,6 +39,57 @@
  */
  void DIO_read(uint8_t pinNumber, uint8_t port, uint8_t *value);
  
+/*
+ * Fast path, the port is given by the address of its register instead of its character, so there is no switch,
+ * and the functions are inlined. With constant arguments an access is a single sbi, cbi or sbis/sbic instruction,
+ * with arguments kept in variables it is a load and store through the address.
+ * Use PORT_ADDRESS(port), DDR_ADDRESS(port) and PIN_ADDRESS(port) for the addresses,
+ * or the DIO_WRITE_PIN and DIO_READ_PIN macros with a constant port character and pin number.
+ * The load and store of the writes aren't atomic, an ISR writing the same port in between loses its change,
+ * so outside an ISR they are called with the interrupts disabled on a port the SW UART ISR writes.
+ */
+
+/*
+ * portAddress: is an input argument that describes the address of the PORTx register of the pin.
+ * mask: is an input argument that describes the pin, bit n for pin n.
+ * value: is an input argument that describes the value on the pin, LOW or HIGH.
+ */
+ static inline void DIO_writeFast(uint16_t portAddress, uint8_t mask, uint8_t value)
+ {
+	if(value)
+	{
+		IO_REG8(portAddress) |= mask;
+	}
+	else
+	{
+		IO_REG8(portAddress) &= ~mask;
+	}
+ }
+
+/*
+ * portAddress: is an input argument that describes the address of the PORTx register.
+ * mask: is an input argument that describes the pins to be changed, bit n for pin n.
+ * value: is an input argument that describes the new levels of the pins in mask, bit n for pin n.
+ * All the pins in mask change together in one write of the port register, the other pins keep their values.
+ */
+ static inline void DIO_writePortFast(uint16_t portAddress, uint8_t mask, uint8_t value)
+ {
+	IO_REG8(portAddress) = (IO_REG8(portAddress) & ~mask) | (value & mask);
+ }
+
+/*
+ * pinAddress: is an input argument that describes the address of the PINx register of the pin.
+ * mask: is an input argument that describes the pin, bit n for pin n.
+ * It returns the value on the pin, LOW or HIGH.
+ */
+ static inline uint8_t DIO_readFast(uint16_t pinAddress, uint8_t mask)
+ {
+	return (IO_REG8(pinAddress) & mask) != 0;
+ }
+
+#define DIO_WRITE_PIN(port, pinNumber, value)	DIO_writeFast(PORT_ADDRESS(port), 1<<(pinNumber), value)
+#define DIO_READ_PIN(port, pinNumber)			DIO_readFast(PIN_ADDRESS(port), 1<<(pinNumber))
+ 
  
  #endif //DIO_H_
  
@@ -4,6 +4,7 @@
 
 #ifndef INTERRUPT_H_
 #define INTERRUPT_H_
+#include "../../Service/RegisterFile.h"
 /**
 *\defgroup interrupts Interrupts driver
 *\ingroup MCAL
@@ -21,6 +22,13 @@
 *@{ 
 */
 
+#ifdef HOST_SIM
+/* in the host build the global interrupt flag and the sleep are modeled by the simulator */
+#include "../../Simulator/Sim.h"
+# define sei()  Sim_sei()
+# define cli()  Sim_cli()
+# define sleep_cpu()  Sim_sleep()
+#else
 /** 
 	*\details
 	*\arg Disables all interrupts by clearing the global interrupt mask.
@@ -43,6 +51,42 @@
 */
 # define cli()  __asm__ __volatile__ ("cli" ::: "memory")
 
+/** 
+    *\details
+    *\arg Puts the CPU to sleep until the next interrupt, if the sleep enable bit in #MCUCR is set.
+	*\arg With the sleep enable bit cleared it does nothing, so it is used as the body of the wait loops.
+	*\arg The macro also implies a <strong><i>memory barrier</i></strong>, so the waited variables are read again.
+
+*/
+# define sleep_cpu()  __asm__ __volatile__ ("sleep" ::: "memory")
+#endif
+
+/**
+	*\details
+	*\arg Selects the idle sleep mode and sets the sleep enable bit in #MCUCR, so #sleep_cpu puts the CPU to sleep.
+	*\arg The idle mode stops only the CPU clock, the timers and the external interrupts go on and wake it.
+
+*/
+# define sleep_enable()  (MCUCR = (MCUCR & ~((1<<SM2)|(1<<SM1)|(1<<SM0))) | (1<<SE))
+
+/**
+	*\details
+	*\arg Clears the sleep enable bit, so a stray #sleep_cpu does nothing.
+
+*/
+# define sleep_disable()  (MCUCR &= ~(1<<SE))
+
+/**
+	*\details
+	*\arg Sleeps in the idle mode until the next interrupt, the body of the wait loops of the drivers.
+	*\arg The sleep enable bit is set only around the sleep instruction, like sleep_mode() of avr-libc.
+	*\arg An interrupt that comes between the check of the loop and the sleep wakes the CPU only at the next one,
+	so a loop that has no other periodic interrupt checks its condition with the interrupts disabled and
+	puts #sei right before #sleep_cpu instead, the instruction after SEI runs before any interrupt.
+
+*/
+# define sleep_idle()  do{ sleep_enable(); sleep_cpu(); sleep_disable(); }while(0)
+
 #define EXT_INT0		__vector_1 /**<This Macro defines IRQ0 Handler						*/
 #define EXT_INT1		__vector_2 /**<This Macro defines IRQ1 Handler						*/
 #define EXT_INT2		__vector_3 /**<This Macro defines IRQ2 Handler						*/
@@ -63,6 +107,35 @@
 #define ANA_COMP		__vector_18/**<This Macro defines Analog Comparator Handler			*/
 #define TWI				__vector_19/**<This Macro defines Two-wire Serial Interface Handler */
 #define SPM_RDY			__vector_20/**<This Macro defines Store Program Memory Ready Handler*/
+/**
+*@name External interrupt 0 control bits
+*\details
+*\arg #INT0 is located in #GICR, #INTF0 in #GIFR and #ISC00, #ISC01 in #MCUCR.
+*\arg INT0 pin is PD2.
+|ISC01  |ISC00  | Description											   |
+|:----: |:----: | :--------------------------------------------------------:|
+|0	   |0	   | The low level of INT0 generates an interrupt request.	   |
+|0	   |1	   | Any logical change on INT0 generates an interrupt request.|
+|1	   |0	   |  The falling edge of INT0 generates an interrupt request. |
+|1	   |1	   | The rising edge of INT0 generates an interrupt request.   |
+*/
+///@{
+#define ISC00	0/**<Bit 0 - ISC00: Interrupt Sense Control 0 Bit 0*/
+#define ISC01	1/**<Bit 1 - ISC01: Interrupt Sense Control 0 Bit 1*/
+#define INTF0	6/**<Bit 6 - INTF0: External Interrupt Flag 0*/
+#define INT0	6/**<Bit 6 - INT0: External Interrupt Request 0 Enable*/
+///@}
+/**
+*@name Sleep control bits
+*\details
+*\arg #SE, #SM0, #SM1 and #SM2 are located in #MCUCR, the idle mode is all the SM bits cleared.
+*/
+///@{
+#define SM0		4/**<Bit 4 - SM0: Sleep Mode Select Bit 0*/
+#define SM1		5/**<Bit 5 - SM1: Sleep Mode Select Bit 1*/
+#define SM2		6/**<Bit 6 - SM2: Sleep Mode Select Bit 2*/
+#define SE		7/**<Bit 7 - SE: Sleep Enable*/
+///@}
 /** 
 *@brief interrupt service routine Macro.
 *@details
@@ -73,8 +146,12 @@
     *\pre \c vector must be one of the interrupt vector names that are
     valid for the particular MCU type.
 */
+#ifdef HOST_SIM
+#define ISR(INT_VECT)	void INT_VECT(void)
+#else
 #define ISR(INT_VECT)	void INT_VECT(void)__attribute__((signal,used));\
 						void INT_VECT(void)
+#endif
 /**@}*/
 
 #endif /* INTERRUPT_H_ */
@@ -1,86 +1,2019 @@
-
 //############# SWUART.c ##############
 #include "SWUART.h"
+#include "../Interrupt/Interrupt.h"
+
+#define SWUART_TX_BUFFER_MASK	(SWUART_TX_BUFFER_SIZE-1)
+#define SWUART_RX_BUFFER_MASK	(SWUART_RX_BUFFER_SIZE-1)
+//data bits + parity bit + first stop bit, sampled after the start bit
+#define SWUART_RX_SAMPLES		(SWUART_DATA_BITS+SWUART_PARITY_BITS+1)
+//one tick per bit puts the sample on the bit edge
+#if SWUART_TICKS_PER_BIT < 2
+#error "the receiver needs at least 2 SWUART_TICKS_PER_BIT"
+#endif
+#if SWUART_RX_MODE == SWUART_RX_MAJORITY_VOTE
+#if SWUART_TICKS_PER_BIT < 3
+#error "SWUART_RX_MAJORITY_VOTE needs at least 3 SWUART_TICKS_PER_BIT"
+#endif
+//the vote is on 3 samples on consecutive ticks around the middle of the bit
+#define SWUART_RX_WINDOW		3
+//the start bit is one more step of the receiver
+#define SWUART_RX_STEPS			(SWUART_RX_SAMPLES+1)
+//the samples of a window are bits 2..0, oldest first, the vote is high for 011, 101, 110 and 111
+#define SWUART_RX_VOTE(samples)		((0xE8>>(samples)) & 0x01)
+//the middle sample outvoted by the samples on both sides of it, 010 or 101, is noise on the line,
+//a sample on the bit edge outvoted alone is only the timing of the window
+#define SWUART_RX_NOISE(samples)	((0x24>>(samples)) & 0x01)
+#else
+#define SWUART_RX_WINDOW		1
+#define SWUART_RX_STEPS			SWUART_RX_SAMPLES
+#define SWUART_RX_VOTE(samples)		(samples)
+#endif
+//the longest bit of a channel in ticks, so its sampling points fit in 8 bit
+#define SWUART_MAX_TICKS_PER_BIT	160
+//a channel bit time may be off its baudrate by 1/SWUART_MAX_BAUDRATE_ERROR after rounding to whole ticks
+#define SWUART_MAX_BAUDRATE_ERROR	50
+#define SWUART_NO_CHANNEL			0xFF
+//the INT0 pin, a channel with RX on it detects the start bit by its falling edge
+#define SWUART_INT0_PORT			D
+#define SWUART_INT0_PIN				2
+#define SWUART_NUM_OF_PORTS			4
+//auto-baud timestamps are counted by Timer 0 in normal mode from this clock source with its prescaler
+#define SWUART_AUTOBAUD_CLK_SOURCE	clkI_DIVISION_BY_8
+#define SWUART_AUTOBAUD_PRESCALER	8
+//edges from the start bit to the first stop bit, the line can change on every bit boundary in between
+#define SWUART_SYNC_MAX_EDGES		(SWUART_FRAME_BITS-SWUART_STOP_FRAME_BITS+1)
+//timestamps of the last edges, a power of 2 that holds the edges of a frame
+#define SWUART_AUTOBAUD_EDGES		16
+#define SWUART_AUTOBAUD_EDGES_MASK	(SWUART_AUTOBAUD_EDGES-1)
+#if SWUART_CLOCK_TRACKING
+//clock tracking of a frame: no edge to time, INT0 waits for the rising edge into the stop bit, the frame is timed
+#define SWUART_TRACK_IDLE			0
+#define SWUART_TRACK_ARMED			1
+#define SWUART_TRACK_EDGE			2
+#endif
+//value of the parity bit for the data bits
+#if SWUART_PARITY == SWUART_PARITY_EVEN
+#define SWUART_PARITY_BIT(data)		SWUART_parity(data)
+#elif SWUART_PARITY == SWUART_PARITY_ODD
+#define SWUART_PARITY_BIT(data)		(SWUART_parity(data) ^ 0x01)
+#elif SWUART_PARITY == SWUART_PARITY_MARK
+#define SWUART_PARITY_BIT(data)		1
+#else
+#define SWUART_PARITY_BIT(data)		0
+#endif
+//data and parity bits of a sampled frame, the receiver shifts the bits in so the data needs no reordering
+#if SWUART_BIT_ORDER == SWUART_LSB_FIRST
+#define SWUART_RX_DATA(frame)		((frame) & SWUART_DATA_MASK)
+#define SWUART_RX_PARITY(frame)		getBit(frame,SWUART_DATA_BITS)
+#define SWUART_RX_STOP(frame)		getBit(frame,SWUART_RX_SAMPLES-1)
+#else
+#define SWUART_RX_DATA(frame)		(((frame)>>(1+SWUART_PARITY_BITS)) & SWUART_DATA_MASK)
+#define SWUART_RX_PARITY(frame)		getBit(frame,1)
+#define SWUART_RX_STOP(frame)		getBit(frame,0)
+#endif
+
+typedef struct
+{
+	uint8_t open;
+	uint8_t txPort;
+	uint8_t txPin;
+	uint8_t rxPort;
+	uint8_t rxPin;
+	//register addresses and masks of the pins, resolved once by SWUART_open for the DIO fast path
+	uint8_t txAddress;
+	uint8_t txMask;
+	uint8_t rxAddress;
+	uint8_t rxMask;
+#if SWUART_RX_INT0
+	//the start bit is detected by INT0 instead of polling RX every tick
+	uint8_t rxOnInt0;
+#endif
+	//the frames are shifted out by the bit-sliced group of the TX port
+	uint8_t txSliced;
+#if SWUART_HALF_DUPLEX
+	//TX and RX are one open drain pin, see SWUART_openHalfDuplex
+	uint8_t halfDuplex;
+	uint8_t txDirAddress;
+#endif
+	//bit time and sampling points in ticks, calculated once by SWUART_open
+	uint8_t ticksPerBit;
+	//ticks from the start bit edge to its middle, or to the middle of the first data bit with a single sample
+	uint8_t rxFirstSample;
+	//ticks from the middle of the start bit to the first sample of the first data bit
+	uint8_t rxFirstWindow;
+	//ticks from the last sample of a bit to the first sample of the next one
+	uint8_t rxNextWindow;
+	//transmit ring buffer, written by SWUART_channelSendAsync and read by the ISR
+	SWUART_data_t txBuffer[SWUART_TX_BUFFER_SIZE];
+	uint8_t txHead;
+	uint8_t txTail;
+	//frame being shifted out, bit 0 is the next bit on the line
+	uint16_t txFrame;
+	uint8_t txBitsLeft;
+	uint8_t txTicks;
+	//data of the frame being shifted out, sent again after a collision while txResend is set
+	SWUART_data_t txData;
+#if SWUART_HALF_DUPLEX
+	uint8_t txResend;
+	uint8_t txRetries;
+	//level of the bit on the line, read back in its middle by a half-duplex channel
+	uint8_t txLevel;
+	//the receiver is getting the frame the half-duplex channel is sending, it isn't put in the buffer
+	uint8_t txEcho;
+	//bit times the line has to stay high before the half-duplex channel starts a frame
+	uint8_t txIdleBits;
+#endif
+	//receive ring buffer, written by the ISR and read by SWUART_channelRead
+	SWUART_data_t rxBuffer[SWUART_RX_BUFFER_SIZE];
+	//SWUART_STATUS_ flags of the bytes in rxBuffer
+	uint8_t rxStatus[SWUART_RX_BUFFER_SIZE];
+	uint8_t rxHead;
+	uint8_t rxTail;
+	//frame being sampled, the first sampled bit ends up as the most significant one, or the least with SWUART_LSB_FIRST
+	uint16_t rxFrame;
+	uint8_t rxBitsLeft;
+	uint8_t rxTicks;
+	//samples left in the window of the current bit and the samples taken so far
+	uint8_t rxWindowLeft;
+	uint8_t rxSamples;
+	//set when a vote of the current frame wasn't unanimous
+	uint8_t rxNoise;
+	//set when a frame was dropped, until the next one is put in the buffer
+	uint8_t rxOverrun;
+#if SWUART_FLOW_CONTROL
+	//SWUART_FLOW_ modes and the register addresses and masks of the RTS and CTS pins
+	uint8_t flowControl;
+	uint8_t rtsAddress;
+	uint8_t rtsMask;
+	uint8_t ctsAddress;
+	uint8_t ctsMask;
+	//the peer was told to stop, by RTS high or SWUART_XOFF, until the receive buffer is down to the low watermark
+	uint8_t rxThrottled;
+	//the peer sent SWUART_XOFF, the transmitter waits for SWUART_XON
+	uint8_t txStopped;
+	//SWUART_XON or SWUART_XOFF to be sent ahead of the transmit buffer, 0 if none
+	uint8_t txFlowChar;
+#endif
+#if SWUART_LINE_MODE
+	//line buffers of the line mode, the line mode is off while lineSize is 0
+	SWUART_data_t *lineBuffers[2];
+	uint8_t lineSize;
+	SWUART_data_t lineDelimiter;
+	//buffer being filled by the ISR, its bytes and the SWUART_STATUS_ flags of its line
+	uint8_t lineFill;
+	uint8_t lineLength;
+	uint8_t lineStatus;
+	//the other buffer holds a line handed to the application, until it is released
+	uint8_t lineReady;
+	uint8_t lineReadyLength;
+	uint8_t lineReadyStatus;
+	//the buffer being filled holds a whole line too, the bytes are dropped until the release
+	uint8_t lineFull;
+#endif
+#if SWUART_DATA_BITS == 9
+	//multidrop addressing, the frames are received only while the last address frame was for nodeAddress
+	uint8_t multidrop;
+	uint8_t nodeAddress;
+	uint8_t addressed;
+#endif
+	ST_SWUART_stats_t stats;
+}ST_SWUART_channel_t;
+
+static volatile ST_SWUART_channel_t SWUART_globalChannels[SWUART_NUM_OF_CHANNELS];
+//Timer 0 compare match frequency, set by the first channel opened
+static uint32_t SWUART_globalTickFrequency = 0;
+#if SWUART_RX_INT0
+//channel served by the INT0 ISR
+static volatile uint8_t SWUART_globalInt0Channel = SWUART_NO_CHANNEL;
+#endif
+//compare matches since the first channel was opened, the time base of the timeouts
+static volatile uint32_t SWUART_globalTicks = 0;
+
+#if SWUART_TX_MODE == SWUART_TX_BIT_SLICED
+//channels with their TX pins on the same port and the same bit time, sending their frames together
+typedef struct
+{
+	//TX pins of the channels in the group, the port write changes only them
+	uint8_t pinMask;
+	uint8_t ticksPerBit;
+	uint8_t ticks;
+	uint8_t bitsLeft;
+	//set when a byte is queued on a channel of the group, so an idle group looks at the channels only then
+	uint8_t pending;
+	//levels of all the TX pins for each bit of the frames, in the order they go on the line
+	uint8_t masks[SWUART_FRAME_BITS];
+}ST_SWUART_txGroup_t;
+
+static volatile ST_SWUART_txGroup_t SWUART_globalTxGroups[SWUART_NUM_OF_PORTS];
+#endif
+
+//auto-baud state, the INT0 ISR only timestamps the edges while it is set
+static volatile uint8_t SWUART_globalAutoBaud = 0;
+static volatile uint32_t SWUART_globalAutoBaudEdges[SWUART_AUTOBAUD_EDGES];
+//line level after each timestamped edge, bit i for SWUART_globalAutoBaudEdges[i]
+static volatile uint16_t SWUART_globalAutoBaudLevels = 0;
+//counts the edges up to 2*SWUART_AUTOBAUD_EDGES, then keeps between SWUART_AUTOBAUD_EDGES and that
+static volatile uint8_t SWUART_globalAutoBaudCount = 0;
+static uint8_t SWUART_globalAutoBaudChecked = 0;
+//bit positions of the edges in the sync frame, counted from its start bit, the even ones are falling
+static uint8_t SWUART_globalSyncPositions[SWUART_SYNC_MAX_EDGES];
+static uint8_t SWUART_globalSyncNumOfEdges = 0;
+//known baudrate of the sync byte measured by SWUART_calibrationDone
+static uint32_t SWUART_globalCalibrationBaudrate = 0;
+
+#if SWUART_CLOCK_TRACKING
+//clock tracking of the INT0 channel, the timestamps are Timer 0 ticks
+static volatile uint8_t SWUART_globalClockTracking = 0;
+static volatile uint8_t SWUART_globalTrackState = SWUART_TRACK_IDLE;
+static volatile uint32_t SWUART_globalTrackStart = 0;
+//ticks from the start edge to the rising edge into the stop bit, SWUART_RX_SAMPLES bit times of the peer
+static volatile uint32_t SWUART_globalTrackSpan = 0;
+//spans of the frames timed since the last SWUART_trackClock
+static volatile uint32_t SWUART_globalTrackCounts = 0;
+static volatile uint8_t SWUART_globalTrackFrames = 0;
+//baudrate of the INT0 channel, the bit time of the peer is measured against it
+static uint32_t SWUART_globalInt0Baudrate = 0;
+#endif
+
+static void SWUART_tick(void);
+
+//idle TX line and pulled up RX line
+static void SWUART_initPins(uint8_t txPort, uint8_t txPin, uint8_t rxPort, uint8_t rxPin)
+{
+	DIO_init(txPin, txPort, OUT);
+	DIO_init(rxPin, rxPort, IN);
+	DIO_write(txPin, txPort, HIGH);
+	//pull up the idle line
+	DIO_write(rxPin, rxPort, HIGH);
+}
+
+
+static uint8_t SWUART_numOfOpenChannels(void)
+{
+	uint8_t numOfOpen = 0;
+	for(uint8_t i = 0; i < SWUART_NUM_OF_CHANNELS; i++)
+	{
+		numOfOpen += SWUART_globalChannels[i].open;
+	}
+	return numOfOpen;
+}
+
+
+static En_SWUART_Error_t SWUART_openPins(uint8_t channel, uint8_t txPort, uint8_t txPin, uint8_t rxPort, uint8_t rxPin, uint32_t baudrate, uint8_t halfDuplex)
+{
+	En_SWUART_Error_t SWUART_error = SWUART_OK;
+	uint16_t ticksPerBit = SWUART_TICKS_PER_BIT;
+	if(channel >= SWUART_NUM_OF_CHANNELS)
+	{
+		SWUART_error = SWUART_WRONG_CHANNEL;
+	}
+	else if((uint8_t)(txPort - A) >= SWUART_NUM_OF_PORTS || (uint8_t)(rxPort - A) >= SWUART_NUM_OF_PORTS || txPin > 7 || rxPin > 7)
+	{
+		SWUART_error = SWUART_WRONG_PIN;
+	}
+	else if(baudrate == 0)
+	{
+		SWUART_error = SWUART_WRONG_BAUDRATE;
+	}
+	else
+	{
+		//the ISR leaves the channel alone while it is set up
+		SWUART_close(channel);
+		if(SWUART_numOfOpenChannels() == 0)
+		{
+			//the first channel sets the tick, prescaler and period are calculated once here
+			//the tick is a periodic compare match on the free running timebase of Timer 0
+			SWUART_globalTickFrequency = baudrate*SWUART_TICKS_PER_BIT;
+			if(Timer0_initPeriodicFrequency(SWUART_globalTickFrequency) != TIMER0_OK)
+			{
+				SWUART_error = SWUART_WRONG_BAUDRATE;
+			}
+		}
+		else
+		{
+			//the other channels count their bit time in whole ticks of the running tick
+			ticksPerBit = (SWUART_globalTickFrequency + baudrate/2) / baudrate;
+			uint32_t bitFrequency = ticksPerBit*baudrate;
+			uint32_t error = bitFrequency > SWUART_globalTickFrequency ? bitFrequency - SWUART_globalTickFrequency : SWUART_globalTickFrequency - bitFrequency;
+			if(ticksPerBit < SWUART_TICKS_PER_BIT || ticksPerBit > SWUART_MAX_TICKS_PER_BIT || SWUART_MAX_BAUDRATE_ERROR*error > SWUART_globalTickFrequency)
+			{
+				SWUART_error = SWUART_WRONG_BAUDRATE;
+			}
+		}
+	}
+	if(SWUART_error == SWUART_OK)
+	{
+		volatile ST_SWUART_channel_t *ch = &SWUART_globalChannels[channel];
+		//start from empty buffers and idle shifters, so a channel can be opened again with a new baudrate
+		ch->txPort = txPort;
+		ch->txPin = txPin;
+		ch->rxPort = rxPort;
+		ch->rxPin = rxPin;
+		ch->txAddress = PORT_ADDRESS(txPort);
+		ch->txMask = 1<<txPin;
+		ch->rxAddress = PIN_ADDRESS(rxPort);
+		ch->rxMask = 1<<rxPin;
+		ch->ticksPerBit = ticksPerBit;
+#if SWUART_RX_MODE == SWUART_RX_MAJORITY_VOTE
+		ch->rxFirstSample = (ticksPerBit+1)/2;
+		ch->rxFirstWindow = ticksPerBit-1;
+#else
+		ch->rxFirstSample = (3*ticksPerBit+1)/2;
+#endif
+		ch->rxNextWindow = ticksPerBit-SWUART_RX_WINDOW+1;
+		ch->txHead = ch->txTail = 0;
+		ch->txBitsLeft = 0;
+		ch->txTicks = ticksPerBit;
+		ch->rxHead = ch->rxTail = 0;
+		ch->rxBitsLeft = 0;
+		ch->rxOverrun = 0;
+#if SWUART_FLOW_CONTROL
+		ch->flowControl = SWUART_FLOW_NONE;
+		ch->rxThrottled = 0;
+		ch->txStopped = 0;
+		ch->txFlowChar = 0;
+#endif
+#if SWUART_LINE_MODE
+		ch->lineSize = 0;
+#endif
+#if SWUART_DATA_BITS == 9
+		ch->multidrop = 0;
+#endif
+		ch->stats = (ST_SWUART_stats_t){0};
+#if SWUART_HALF_DUPLEX
+		ch->txDirAddress = DDR_ADDRESS(txPort);
+		ch->txResend = 0;
+		ch->txEcho = 0;
+		ch->txIdleBits = halfDuplex ? SWUART_FRAME_BITS : 0;
+		ch->halfDuplex = halfDuplex;
+		if(halfDuplex)
+		{
+			//the bus pin is released, it is never driven high
+			DIO_init(rxPin, rxPort, IN);
+			DIO_write(rxPin, rxPort, HIGH);
+		}
+		else
+#endif
+		{
+			SWUART_initPins(txPort, txPin, rxPort, rxPin);
+		}
+		ch->txSliced = 0;
+#if SWUART_TX_MODE == SWUART_TX_BIT_SLICED
+		volatile ST_SWUART_txGroup_t *group = &SWUART_globalTxGroups[txPort - A];
+		cli();
+		if(group->pinMask == 0)
+		{
+			group->ticksPerBit = ticksPerBit;
+			group->ticks = ticksPerBit;
+			group->bitsLeft = 0;
+		}
+		//a channel with another bit time on the same port sends its frames by itself, like a half-duplex one
+		if(group->ticksPerBit == ticksPerBit && !halfDuplex)
+		{
+			ch->txSliced = 1;
+			//the new pin is idle until the frames in flight end
+			for(uint8_t i = 0; i < SWUART_FRAME_BITS; i++)
+			{
+				group->masks[i] |= 1<<txPin;
+			}
+			group->pinMask |= 1<<txPin;
+		}
+		sei();
+#else
+		(void)halfDuplex;
+#endif
+#if SWUART_RX_INT0
+		ch->rxOnInt0 = rxPort == SWUART_INT0_PORT && rxPin == SWUART_INT0_PIN;
+		if(ch->rxOnInt0)
+		{
+			//start bit detection on the falling edge of INT0
+			SWUART_globalInt0Channel = channel;
+#if SWUART_CLOCK_TRACKING
+			SWUART_globalInt0Baudrate = baudrate;
+			SWUART_globalTrackState = SWUART_TRACK_IDLE;
+			SWUART_globalTrackCounts = 0;
+			SWUART_globalTrackFrames = 0;
+#endif
+			setBit(MCUCR,ISC01);
+			clrBit(MCUCR,ISC00);
+			setBit(GICR,INT0);
+		}
+#endif
+		if(SWUART_numOfOpenChannels() == 0)
+		{
+			//the bit clock is the periodic client of the timer service
+			TimerService_setClient(SWUART_tick);
+			Timer0_interruptEnable(TIMER0_OUT_CMP_MATCH_INT);
+		}
+		ch->open = 1;
+	}
+	return SWUART_error;
+}
+
+
+En_SWUART_Error_t SWUART_open(uint8_t channel, uint8_t port, uint8_t txPin, uint8_t rxPin, uint32_t baudrate)
+{
+	return SWUART_openPins(channel, port, txPin, port, rxPin, baudrate, 0);
+}
+
+
+#if SWUART_HALF_DUPLEX
+En_SWUART_Error_t SWUART_openHalfDuplex(uint8_t channel, uint8_t port, uint8_t pin, uint32_t baudrate)
+{
+	return SWUART_openPins(channel, port, pin, port, pin, baudrate, 1);
+}
+#endif
+
+
+void SWUART_close(uint8_t channel)
+{
+	if(channel < SWUART_NUM_OF_CHANNELS)
+	{
+		volatile ST_SWUART_channel_t *ch = &SWUART_globalChannels[channel];
+#if SWUART_TX_MODE == SWUART_TX_BIT_SLICED
+		if(ch->open && ch->txSliced)
+		{
+			SWUART_globalTxGroups[ch->txPort - A].pinMask &= ~(1<<ch->txPin);
+		}
+#endif
+		ch->open = 0;
+#if SWUART_RX_INT0
+		if(SWUART_globalInt0Channel == channel)
+		{
+			clrBit(GICR,INT0);
+			SWUART_globalInt0Channel = SWUART_NO_CHANNEL;
+		}
+#endif
+		//no tick is needed without channels, the software timers keep the compare match
+		if(SWUART_numOfOpenChannels() == 0)
+		{
+			TimerService_setClient(0);
+		}
+	}
+}
 
-uint8_t parityState = PARITY_NOK;
 
-float64_t bitTime = 0;
 void SWUART_init(uint32_t baudrate)
 {
-	DIO_init(TX, UART_PORT, OUT);
-	DIO_init(RX, UART_PORT, IN);
-	DIO_write(TX, UART_PORT, HIGH);
-	Timer0_init(NORMAL,clkI_No_DIVISON);
-	bitTime = (float64_t)1/baudrate;
+	SWUART_globalAutoBaud = 0;
+	//the edges timestamped by auto-baud are done, INT0 is enabled again only for a channel with RX on it
+	clrBit(GICR,INT0);
+	for(uint8_t i = 0; i < SWUART_NUM_OF_CHANNELS; i++)
+	{
+		SWUART_close(i);
+	}
+	SWUART_openPins(SWUART_DEFAULT_CHANNEL, UART_PORT, TX, UART_RX_PORT, RX, baudrate, 0);
+}
+
+
+#if SWUART_PARITY == SWUART_PARITY_EVEN || SWUART_PARITY == SWUART_PARITY_ODD
+//returns 1 if the number of ones in the data bits is odd
+static uint8_t SWUART_parity(uint16_t data)
+{
+	data ^= data>>8;
+	data ^= data>>4;
+	data ^= data>>2;
+	data ^= data>>1;
+	return data & 0x01;
 }
+#endif
 
 
-//1010111001
-void SWUART_send(uint8_t data)
+//builds the frame in the order it goes on the line: start, data in SWUART_BIT_ORDER, parity, stop bits
+static uint16_t SWUART_buildFrame(SWUART_data_t data)
 {
-	//start bit
-	DIO_write(TX, UART_PORT, LOW);
-	Timer0_delay_ms(bitTime);
-	//send data bits
-	uint8_t parity = 0;
-	for(uint8_t i = 0; i < 8;i++)
+	uint16_t bits = data & SWUART_DATA_MASK;
+#if SWUART_BIT_ORDER == SWUART_MSB_FIRST
+	uint16_t frame = 0;
+	for(uint8_t i = 0; i < SWUART_DATA_BITS; i++)
 	{
-		parity ^=getBit(data,7-i);
-		DIO_write(TX, UART_PORT, getBit(data,7-i));
-		Timer0_delay_ms(bitTime);
+		frame |= (uint16_t)getBit(bits,(SWUART_DATA_BITS-1-i))<<(i+1);
 	}
-	//send parity bit
-	DIO_write(TX, UART_PORT, parity);
-	Timer0_delay_ms(bitTime);
-	//stop bit
-	DIO_write(TX, UART_PORT, HIGH);
-	Timer0_delay_ms(2*bitTime);
+#else
+	uint16_t frame = bits<<1;
+#endif
+#if SWUART_PARITY != SWUART_PARITY_NONE
+	frame |= (uint16_t)SWUART_PARITY_BIT(bits)<<(SWUART_DATA_BITS+1);
+#endif
+	frame |= (uint16_t)((1<<SWUART_STOP_FRAME_BITS)-1)<<(SWUART_DATA_BITS+SWUART_PARITY_BITS+1);
+	return frame;
 }
 
 
-void SWUART_recieve(uint8_t *data)
+void SWUART_autoBaudStart(void)
 {
-	uint8_t bitValue = 0;
-	*data = 0;
-	uint8_t parity = 0;
-	uint8_t parityRec = 0;
-	
-	
-	//wait start bit
-	do
+	//the tick of all the channels is stopped with the last one while Timer 0 timestamps the edges
+	for(uint8_t i = 0; i < SWUART_NUM_OF_CHANNELS; i++)
+	{
+		SWUART_close(i);
+	}
+	//the edges the sync byte puts on the line up to its first stop bit
+	uint16_t frame = SWUART_buildFrame(SWUART_SYNC_BYTE);
+	uint8_t level = 1;
+	SWUART_globalSyncNumOfEdges = 0;
+	for(uint8_t i = 0; i < SWUART_FRAME_BITS; i++)
+	{
+		uint8_t bitValue = getBit(frame,i);
+		if(bitValue != level)
+		{
+			SWUART_globalSyncPositions[SWUART_globalSyncNumOfEdges++] = i;
+		}
+		level = bitValue;
+	}
+	SWUART_globalAutoBaudCount = SWUART_globalAutoBaudChecked = 0;
+	SWUART_globalAutoBaud = 1;
+	SWUART_initPins(UART_PORT, TX, UART_RX_PORT, RX);
+	//both edges are timestamped
+	setBit(MCUCR,ISC00);
+	clrBit(MCUCR,ISC01);
+	setBit(GICR,INT0);
+	//the timestamps are the timebase ticks at the known auto-baud clock
+	Timer0_initTimebase(SWUART_AUTOBAUD_CLK_SOURCE);
+	sei();
+}
+
+
+//checks the last edges against the sync frame, falling and rising in turn and all of them within a quarter bit
+static uint8_t SWUART_syncMatches(const uint32_t *edges, uint16_t levels)
+{
+	//the levels after the even edges are low and after the odd ones high
+	uint8_t matches = levels == (0xAAAA & ((1U<<SWUART_globalSyncNumOfEdges)-1));
+	uint8_t last = SWUART_globalSyncNumOfEdges-1;
+	uint32_t span = edges[last] - edges[0];
+	uint8_t bits = SWUART_globalSyncPositions[last] - SWUART_globalSyncPositions[0];
+	for(uint8_t i = 1; i < last && matches; i++)
+	{
+		//both scaled by bits, so the bit time isn't divided
+		uint32_t measured = (edges[i] - edges[0]) * bits;
+		uint32_t expected = (uint32_t)(SWUART_globalSyncPositions[i] - SWUART_globalSyncPositions[0]) * span;
+		uint32_t error = measured > expected ? measured - expected : expected - measured;
+		matches = 4*error <= span;
+	}
+	return matches && span != 0;
+}
+
+
+//takes the newest edges timestamped by INT0, and returns 1 with their span in system clock cycles
+//and in bit times if they are the edges of the sync frame
+static uint8_t SWUART_syncMeasure(uint32_t *span, uint8_t *bits)
+{
+	uint8_t matches = 0;
+	uint32_t edges[SWUART_SYNC_MAX_EDGES];
+	uint16_t levels = 0;
+	uint8_t numOfEdges = SWUART_globalSyncNumOfEdges;
+	cli();
+	uint8_t count = SWUART_globalAutoBaudCount;
+	uint8_t newEdge = count != SWUART_globalAutoBaudChecked && count >= numOfEdges;
+	if(newEdge)
+	{
+		//the newest edges, oldest first
+		for(uint8_t i = 0; i < numOfEdges; i++)
+		{
+			uint8_t index = (uint8_t)(count - numOfEdges + i) & SWUART_AUTOBAUD_EDGES_MASK;
+			edges[i] = SWUART_globalAutoBaudEdges[index];
+			levels |= (uint16_t)getBit(SWUART_globalAutoBaudLevels,index)<<i;
+		}
+	}
+	sei();
+	SWUART_globalAutoBaudChecked = count;
+	if(newEdge && SWUART_syncMatches(edges, levels))
+	{
+		*span = (edges[numOfEdges-1] - edges[0]) * SWUART_AUTOBAUD_PRESCALER;
+		*bits = SWUART_globalSyncPositions[numOfEdges-1] - SWUART_globalSyncPositions[0];
+		matches = 1;
+	}
+	return matches;
+}
+
+
+En_SWUART_Error_t SWUART_autoBaudDone(uint32_t *baudrate)
+{
+	En_SWUART_Error_t SWUART_error = SWUART_AUTOBAUD_PENDING;
+	uint32_t span;
+	uint8_t bits;
+	if(SWUART_syncMeasure(&span, &bits))
+	{
+		uint32_t detected = (Timer0_getClock()*bits + span/2) / span;
+		//a baudrate that Timer 0 can't generate is ignored and the next sync byte is waited,
+		//Timer 0 is programmed only once, by SWUART_init
+		if(Timer0_checkPeriodicFrequency(detected*SWUART_TICKS_PER_BIT) == TIMER0_OK)
+		{
+			SWUART_init(detected);
+			*baudrate = detected;
+			SWUART_error = SWUART_OK;
+		}
+	}
+	return SWUART_error;
+}
+
+
+uint32_t SWUART_autoBaud(void)
+{
+	uint32_t baudrate = 0;
+	SWUART_autoBaudStart();
+	//wait until the sync byte is detected
+	while(SWUART_autoBaudDone(&baudrate) != SWUART_OK)
+	{
+		sleep_idle();
+	}
+	return baudrate;
+}
+
+
+//returns 1 if the measured clock is within 1/SWUART_CLOCK_RANGE of SYSTEM_CLK
+static uint8_t SWUART_clockInRange(uint32_t clock)
+{
+	uint32_t error = clock > SYSTEM_CLK ? clock - SYSTEM_CLK : SYSTEM_CLK - clock;
+	return SWUART_CLOCK_RANGE*error <= SYSTEM_CLK;
+}
+
+
+void SWUART_calibrationStart(uint32_t baudrate)
+{
+	SWUART_globalCalibrationBaudrate = baudrate;
+	SWUART_autoBaudStart();
+}
+
+
+En_SWUART_Error_t SWUART_calibrationDone(uint32_t *clock)
+{
+	En_SWUART_Error_t SWUART_error = SWUART_AUTOBAUD_PENDING;
+	uint32_t span;
+	uint8_t bits;
+	if(SWUART_syncMeasure(&span, &bits))
+	{
+		//the span is bits bit times of the peer, counted in cycles of the real clock
+		uint32_t measured = (span*SWUART_globalCalibrationBaudrate + bits/2) / bits;
+		if(SWUART_clockInRange(measured))
+		{
+			Timer0_setClock(measured);
+			SWUART_init(SWUART_globalCalibrationBaudrate);
+			*clock = measured;
+			SWUART_error = SWUART_OK;
+		}
+	}
+	return SWUART_error;
+}
+
+
+uint32_t SWUART_calibrate(uint32_t baudrate)
+{
+	uint32_t clock = 0;
+	SWUART_calibrationStart(baudrate);
+	//wait until the sync byte is measured
+	while(SWUART_calibrationDone(&clock) != SWUART_OK)
+	{
+		sleep_idle();
+	}
+	return clock;
+}
+
+
+#if SWUART_CLOCK_TRACKING
+void SWUART_setClockTracking(uint8_t enable)
+{
+	cli();
+	SWUART_globalClockTracking = enable;
+	SWUART_globalTrackState = SWUART_TRACK_IDLE;
+	SWUART_globalTrackCounts = 0;
+	SWUART_globalTrackFrames = 0;
+	sei();
+}
+
+
+En_SWUART_Error_t SWUART_trackClock(uint32_t *clock)
+{
+	En_SWUART_Error_t SWUART_error = SWUART_NO_DATA;
+	if(SWUART_globalTrackFrames >= SWUART_CLOCK_TRACK_FRAMES)
+	{
+		cli();
+		uint32_t counts = SWUART_globalTrackCounts;
+		SWUART_globalTrackCounts = 0;
+		SWUART_globalTrackFrames = 0;
+		sei();
+		//Timer 0 ticks in a bit time of the peer in 1/16, then the cycles in a second of the peer bit times
+		uint32_t bitTicks = (counts*16 + SWUART_CLOCK_TRACK_FRAMES*SWUART_RX_SAMPLES/2) / (SWUART_CLOCK_TRACK_FRAMES*SWUART_RX_SAMPLES);
+		uint32_t measured = (SWUART_globalInt0Baudrate*Timer0_getPrescaler()*bitTicks + 8) / 16;
+		if(SWUART_clockInRange(measured))
+		{
+			Timer0_setClock(measured);
+			//the tick is rescaled from its next match, a frame in flight isn't disturbed
+			Timer0_setPeriodicFrequency(SWUART_globalTickFrequency);
+			*clock = measured;
+			SWUART_error = SWUART_OK;
+		}
+	}
+	return SWUART_error;
+}
+#endif
+
+
+#if SWUART_FLOW_CONTROL
+//tells the peer to stop or to go on sending, by RTS and by SWUART_XOFF or SWUART_XON, the interrupts must be disabled
+static void SWUART_rxThrottle(volatile ST_SWUART_channel_t *ch, uint8_t stop)
+{
+	ch->rxThrottled = stop;
+	if(ch->flowControl & SWUART_FLOW_RTS_CTS)
+	{
+		DIO_writeFast(ch->rtsAddress, ch->rtsMask, stop);
+	}
+	if(ch->flowControl & SWUART_FLOW_XON_XOFF)
+	{
+		//a SWUART_XOFF not sent yet is replaced, the peer takes the extra SWUART_XON as a no-op
+		ch->txFlowChar = stop ? SWUART_XOFF : SWUART_XON;
+#if SWUART_TX_MODE == SWUART_TX_BIT_SLICED
+		if(ch->txSliced)
+		{
+			SWUART_globalTxGroups[ch->txPort - A].pending = 1;
+		}
+#endif
+	}
+}
+#endif
+
+
+//returns the channel state, or null if the channel isn't open
+static volatile ST_SWUART_channel_t *SWUART_getChannel(uint8_t channel)
+{
+	volatile ST_SWUART_channel_t *ch = 0;
+	if(channel < SWUART_NUM_OF_CHANNELS && SWUART_globalChannels[channel].open)
 	{
-		DIO_read(RX,UART_PORT , &bitValue);
-	}while(bitValue!=0);
-	Timer0_delay_ms(bitTime);
-	
-	//recieve data bits
-	for(uint8_t i = 0; i < 8;i++)
+		ch = &SWUART_globalChannels[channel];
+	}
+	return ch;
+}
+
+
+En_SWUART_Error_t SWUART_channelSend(uint8_t channel, SWUART_data_t data)
+{
+	En_SWUART_Error_t SWUART_error;
+	//wait for a free place in the transmit buffer
+	while((SWUART_error = SWUART_channelSendAsync(channel, data)) == SWUART_TX_BUFFER_FULL)
+	{
+		sleep_idle();
+	}
+	return SWUART_error;
+}
+
+
+En_SWUART_Error_t SWUART_channelSendAsync(uint8_t channel, SWUART_data_t data)
+{
+	En_SWUART_Error_t SWUART_error = SWUART_OK;
+	volatile ST_SWUART_channel_t *ch = SWUART_getChannel(channel);
+	if(ch == 0)
+	{
+		SWUART_error = SWUART_WRONG_CHANNEL;
+	}
+	else
+	{
+		uint8_t nextHead = (ch->txHead+1) & SWUART_TX_BUFFER_MASK;
+		if(nextHead == ch->txTail)
+		{
+			SWUART_error = SWUART_TX_BUFFER_FULL;
+		}
+		else
+		{
+			ch->txBuffer[ch->txHead] = data;
+			ch->txHead = nextHead;
+			uint8_t used = (nextHead - ch->txTail) & SWUART_TX_BUFFER_MASK;
+			if(used > ch->stats.maxTxUsed)
+			{
+				ch->stats.maxTxUsed = used;
+			}
+#if SWUART_TX_MODE == SWUART_TX_BIT_SLICED
+			if(ch->txSliced)
+			{
+				SWUART_globalTxGroups[ch->txPort - A].pending = 1;
+			}
+#endif
+		}
+	}
+	return SWUART_error;
+}
+
+
+uint8_t SWUART_channelWrite(uint8_t channel, const SWUART_data_t *data, uint8_t length)
+{
+	uint8_t i = 0;
+	while(i < length && SWUART_channelSendAsync(channel, data[i]) == SWUART_OK)
+	{
+		i++;
+	}
+	return i;
+}
+
+
+uint8_t SWUART_channelTxFree(uint8_t channel)
+{
+	uint8_t txFree = 0;
+	volatile ST_SWUART_channel_t *ch = SWUART_getChannel(channel);
+	if(ch != 0)
+	{
+		txFree = (ch->txTail - ch->txHead - 1) & SWUART_TX_BUFFER_MASK;
+	}
+	return txFree;
+}
+
+
+uint8_t SWUART_channelTxIdle(uint8_t channel)
+{
+	uint8_t txIdle = 1;
+	volatile ST_SWUART_channel_t *ch = SWUART_getChannel(channel);
+	if(ch != 0)
+	{
+		txIdle = ch->txBitsLeft == 0 && ch->txHead == ch->txTail;
+#if SWUART_HALF_DUPLEX
+		txIdle &= !ch->txResend;
+#endif
+#if SWUART_FLOW_CONTROL
+		txIdle &= ch->txFlowChar == 0;
+#endif
+	}
+	return txIdle;
+}
+
+
+uint8_t SWUART_channelAvailable(uint8_t channel)
+{
+	uint8_t available = 0;
+	volatile ST_SWUART_channel_t *ch = SWUART_getChannel(channel);
+	if(ch != 0)
+	{
+		available = (ch->rxHead - ch->rxTail) & SWUART_RX_BUFFER_MASK;
+	}
+	return available;
+}
+
+
+uint16_t SWUART_channelRxGlitches(uint8_t channel)
+{
+	uint16_t glitches = 0;
+	volatile ST_SWUART_channel_t *ch = SWUART_getChannel(channel);
+	if(ch != 0)
+	{
+		//the counter is 16 bit, so it is read with the ISR held off
+		cli();
+		glitches = ch->stats.glitches;
+		sei();
+	}
+	return glitches;
+}
+
+
+En_SWUART_Error_t SWUART_channelGetStats(uint8_t channel, ST_SWUART_stats_t *stats)
+{
+	En_SWUART_Error_t SWUART_error = SWUART_OK;
+	volatile ST_SWUART_channel_t *ch = SWUART_getChannel(channel);
+	if(ch == 0)
+	{
+		SWUART_error = SWUART_WRONG_CHANNEL;
+	}
+	else
+	{
+		//a consistent copy, the ISR updates the counters in the middle of the frames
+		cli();
+		*stats = ch->stats;
+		sei();
+	}
+	return SWUART_error;
+}
+
+
+void SWUART_channelResetStats(uint8_t channel)
+{
+	volatile ST_SWUART_channel_t *ch = SWUART_getChannel(channel);
+	if(ch != 0)
+	{
+		cli();
+		ch->stats = (ST_SWUART_stats_t){0};
+		sei();
+	}
+}
+
+
+#if SWUART_FLOW_CONTROL
+En_SWUART_Error_t SWUART_channelSetFlowControl(uint8_t channel, uint8_t flowControl, uint8_t port, uint8_t rtsPin, uint8_t ctsPin)
+{
+	En_SWUART_Error_t SWUART_error = SWUART_OK;
+	volatile ST_SWUART_channel_t *ch = SWUART_getChannel(channel);
+	if(ch == 0)
+	{
+		SWUART_error = SWUART_WRONG_CHANNEL;
+	}
+	else if((flowControl & SWUART_FLOW_RTS_CTS) && ((uint8_t)(port - A) >= SWUART_NUM_OF_PORTS || rtsPin > 7 || ctsPin > 7))
+	{
+		SWUART_error = SWUART_WRONG_PIN;
+	}
+	else
+	{
+		if(flowControl & SWUART_FLOW_RTS_CTS)
+		{
+			//RTS starts high until the buffer level is checked below, CTS is pulled up so a missing peer holds the frames
+			DIO_init(rtsPin, port, OUT);
+			DIO_write(rtsPin, port, HIGH);
+			DIO_init(ctsPin, port, IN);
+			DIO_write(ctsPin, port, HIGH);
+		}
+		cli();
+		ch->rtsAddress = PORT_ADDRESS(port);
+		ch->rtsMask = 1<<rtsPin;
+		ch->ctsAddress = PIN_ADDRESS(port);
+		ch->ctsMask = 1<<ctsPin;
+		ch->flowControl = flowControl;
+		ch->txStopped = 0;
+		ch->txFlowChar = 0;
+		if(flowControl == SWUART_FLOW_NONE)
+		{
+			ch->rxThrottled = 0;
+		}
+		else
+		{
+			SWUART_rxThrottle(ch, ((ch->rxHead - ch->rxTail) & SWUART_RX_BUFFER_MASK) >= SWUART_RX_HIGH_WATERMARK);
+			//the peer is known to be going on, no SWUART_XON is needed to start
+			if(!ch->rxThrottled)
+			{
+				ch->txFlowChar = 0;
+			}
+		}
+		sei();
+	}
+	return SWUART_error;
+}
+#endif
+
+
+#if SWUART_LINE_MODE
+En_SWUART_Error_t SWUART_channelSetLineMode(uint8_t channel, SWUART_data_t *buffer0, SWUART_data_t *buffer1, uint8_t size, SWUART_data_t delimiter)
+{
+	En_SWUART_Error_t SWUART_error = SWUART_OK;
+	volatile ST_SWUART_channel_t *ch = SWUART_getChannel(channel);
+	if(ch == 0)
+	{
+		SWUART_error = SWUART_WRONG_CHANNEL;
+	}
+	else
+	{
+		cli();
+		ch->lineBuffers[0] = buffer0;
+		ch->lineBuffers[1] = buffer1;
+		ch->lineSize = buffer0 != 0 && buffer1 != 0 ? size : 0;
+		ch->lineDelimiter = delimiter;
+		ch->lineFill = 0;
+		ch->lineLength = 0;
+		ch->lineStatus = SWUART_STATUS_OK;
+		ch->lineReady = 0;
+		ch->lineFull = 0;
+		sei();
+	}
+	return SWUART_error;
+}
+
+
+//hands the line in the buffer being filled to the application and fills the other buffer, lineReady must be 0
+static void SWUART_linePublish(volatile ST_SWUART_channel_t *ch)
+{
+	ch->lineReadyLength = ch->lineLength;
+	ch->lineReadyStatus = ch->lineStatus;
+	ch->lineFill ^= 1;
+	ch->lineLength = 0;
+	ch->lineStatus = SWUART_STATUS_OK;
+	ch->lineFull = 0;
+	ch->lineReady = 1;
+}
+
+
+En_SWUART_Error_t SWUART_channelTryReceiveLine(uint8_t channel, SWUART_data_t **line, uint8_t *length, uint8_t *status)
+{
+	En_SWUART_Error_t SWUART_error = SWUART_OK;
+	volatile ST_SWUART_channel_t *ch = SWUART_getChannel(channel);
+	if(ch == 0)
+	{
+		SWUART_error = SWUART_WRONG_CHANNEL;
+	}
+	else if(!ch->lineReady)
+	{
+		SWUART_error = SWUART_NO_DATA;
+	}
+	else
+	{
+		//the ISR leaves the handed over line alone until the release
+		*line = ch->lineBuffers[ch->lineFill ^ 1];
+		*length = ch->lineReadyLength;
+		*status = ch->lineReadyStatus;
+	}
+	return SWUART_error;
+}
+
+
+En_SWUART_Error_t SWUART_channelReceiveLine(uint8_t channel, SWUART_data_t **line, uint8_t *length, uint8_t *status)
+{
+	En_SWUART_Error_t SWUART_error;
+	volatile ST_SWUART_channel_t *ch = SWUART_getChannel(channel);
+	//wait until a line is received
+	while((SWUART_error = SWUART_channelTryReceiveLine(channel, line, length, status)) == SWUART_NO_DATA && ch->lineSize != 0)
+	{
+		sleep_idle();
+	}
+	return SWUART_error;
+}
+
+
+En_SWUART_Error_t SWUART_channelReleaseLine(uint8_t channel)
+{
+	En_SWUART_Error_t SWUART_error = SWUART_OK;
+	volatile ST_SWUART_channel_t *ch = SWUART_getChannel(channel);
+	if(ch == 0)
+	{
+		SWUART_error = SWUART_WRONG_CHANNEL;
+	}
+	else if(!ch->lineReady)
 	{
-		DIO_read(RX,UART_PORT , &bitValue);
-		Timer0_delay_ms(bitTime);
-		*data = (*data)<<i;
-		*data |=bitValue;
-		parity ^=bitValue;
+		SWUART_error = SWUART_NO_DATA;
 	}
-	//recieve parity bit
-	DIO_read(RX,UART_PORT , &parityRec);
-	Timer0_delay_ms(bitTime);
-	
-	//recieve stop bits
-	DIO_read(RX,UART_PORT , &bitValue);
-	Timer0_delay_ms(bitTime);
-	DIO_read(RX,UART_PORT , &bitValue);
-	Timer0_delay_ms(bitTime);
-	
-	if(parity == parityRec)
+	else
+	{
+		cli();
+		ch->lineReady = 0;
+		//the line that ended meanwhile is handed over, and its buffer is refilled
+		if(ch->lineFull)
+		{
+			SWUART_linePublish(ch);
+		}
+		sei();
+	}
+	return SWUART_error;
+}
+#endif
+
+
+#if SWUART_DATA_BITS == 9
+En_SWUART_Error_t SWUART_channelSetMultidrop(uint8_t channel, uint8_t enable, uint8_t address)
+{
+	En_SWUART_Error_t SWUART_error = SWUART_OK;
+	volatile ST_SWUART_channel_t *ch = SWUART_getChannel(channel);
+	if(ch == 0)
 	{
-		parityState = PARITY_OK;
+		SWUART_error = SWUART_WRONG_CHANNEL;
 	}
 	else
 	{
-		parityState = PARITY_NOK;
+		cli();
+		ch->multidrop = enable;
+		ch->nodeAddress = address;
+		ch->addressed = 0;
+		sei();
+	}
+	return SWUART_error;
+}
+
+
+En_SWUART_Error_t SWUART_channelSendAddress(uint8_t channel, uint8_t address)
+{
+	return SWUART_channelSend(channel, SWUART_ADDRESS_MARK | address);
+}
+#endif
+
+
+En_SWUART_Error_t SWUART_channelTryReceiveStatus(uint8_t channel, SWUART_data_t *data, uint8_t *status)
+{
+	En_SWUART_Error_t SWUART_error = SWUART_OK;
+	volatile ST_SWUART_channel_t *ch = SWUART_getChannel(channel);
+	if(ch == 0)
+	{
+		SWUART_error = SWUART_WRONG_CHANNEL;
+	}
+	else if(ch->rxHead == ch->rxTail)
+	{
+		SWUART_error = SWUART_NO_DATA;
+	}
+	else
+	{
+		*data = ch->rxBuffer[ch->rxTail];
+		*status = ch->rxStatus[ch->rxTail];
+		ch->rxTail = (ch->rxTail+1) & SWUART_RX_BUFFER_MASK;
+#if SWUART_FLOW_CONTROL
+		//the peer goes on once the application has made room
+		if(ch->rxThrottled && ((ch->rxHead - ch->rxTail) & SWUART_RX_BUFFER_MASK) <= SWUART_RX_LOW_WATERMARK)
+		{
+			cli();
+			SWUART_rxThrottle(ch, 0);
+			sei();
+		}
+#endif
+	}
+	return SWUART_error;
+}
+
+
+En_SWUART_Error_t SWUART_channelTryReceive(uint8_t channel, SWUART_data_t *data)
+{
+	uint8_t status;
+	return SWUART_channelTryReceiveStatus(channel, data, &status);
+}
+
+
+SWUART_data_t SWUART_channelRead(uint8_t channel)
+{
+	SWUART_data_t data = 0;
+	SWUART_channelTryReceive(channel, &data);
+	return data;
+}
+
+
+En_SWUART_Error_t SWUART_channelReceive(uint8_t channel, SWUART_data_t *data)
+{
+	En_SWUART_Error_t SWUART_error;
+	//wait until a byte is received
+	while((SWUART_error = SWUART_channelTryReceive(channel, data)) == SWUART_NO_DATA)
+	{
+		sleep_idle();
+	}
+	return SWUART_error;
+}
+
+
+//the tick count is 32 bit, so it is read with the ISR held off
+static uint32_t SWUART_getTicks(void)
+{
+	cli();
+	uint32_t ticks = SWUART_globalTicks;
+	sei();
+	return ticks;
+}
+
+
+En_SWUART_Error_t SWUART_channelReceiveTimeout(uint8_t channel, SWUART_data_t *data, uint32_t ticks)
+{
+	uint32_t start = SWUART_getTicks();
+	En_SWUART_Error_t SWUART_error = SWUART_channelTryReceive(channel, data);
+	//every tick wakes the CPU, so the deadline is checked on time
+	while(SWUART_error == SWUART_NO_DATA)
+	{
+		if(SWUART_getTicks() - start >= ticks)
+		{
+			SWUART_error = SWUART_TIMEOUT;
+		}
+		else
+		{
+			sleep_idle();
+			SWUART_error = SWUART_channelTryReceive(channel, data);
+		}
+	}
+	return SWUART_error;
+}
+
+
+En_SWUART_Error_t SWUART_channelSendBuffer(uint8_t channel, const SWUART_data_t *data, uint16_t length)
+{
+	En_SWUART_Error_t SWUART_error = SWUART_OK;
+	if(SWUART_getChannel(channel) == 0)
+	{
+		SWUART_error = SWUART_WRONG_CHANNEL;
+	}
+	else
+	{
+		while(length != 0 && SWUART_error == SWUART_OK)
+		{
+			uint8_t chunk = length > 0xFF ? 0xFF : length;
+			uint8_t queued = SWUART_channelWrite(channel, data, chunk);
+			data += queued;
+			length -= queued;
+			//wait for the ISR to take a byte out of the full buffer
+			if(queued < chunk)
+			{
+				sleep_idle();
+				//a channel closed meanwhile never empties its buffer
+				if(SWUART_getChannel(channel) == 0)
+				{
+					SWUART_error = SWUART_WRONG_CHANNEL;
+				}
+			}
+		}
+	}
+	return SWUART_error;
+}
+
+
+uint16_t SWUART_channelReceiveBuffer(uint8_t channel, SWUART_data_t *data, uint16_t length, uint16_t timeout)
+{
+	uint16_t received = 0;
+	volatile ST_SWUART_channel_t *ch = SWUART_getChannel(channel);
+#if SWUART_LINE_MODE
+	//in the line mode the bytes go to the line buffers, so none would come here
+	if(ch != 0 && ch->lineSize != 0)
+	{
+		ch = 0;
+	}
+#endif
+	if(ch != 0)
+	{
+		//milliseconds to ticks, split so the products fit in 32 bit
+		uint32_t timeoutTicks = timeout*(SWUART_globalTickFrequency/1000) + timeout*(SWUART_globalTickFrequency%1000)/1000;
+		uint32_t start = SWUART_getTicks();
+		uint8_t timedOut = 0;
+		while(received < length && !timedOut && ch->open)
+		{
+			if(SWUART_channelAvailable(channel) != 0)
+			{
+				data[received++] = SWUART_channelRead(channel);
+			}
+			else if(timeout != SWUART_NO_TIMEOUT && SWUART_getTicks() - start >= timeoutTicks)
+			{
+				timedOut = 1;
+			}
+			else
+			{
+				sleep_idle();
+			}
+		}
+	}
+	return received;
+}
+
+
+void SWUART_send(SWUART_data_t data)
+{
+	SWUART_channelSend(SWUART_DEFAULT_CHANNEL, data);
+}
+
+
+En_SWUART_Error_t SWUART_sendAsync(SWUART_data_t data)
+{
+	return SWUART_channelSendAsync(SWUART_DEFAULT_CHANNEL, data);
+}
+
+
+uint8_t SWUART_write(const SWUART_data_t *data, uint8_t length)
+{
+	return SWUART_channelWrite(SWUART_DEFAULT_CHANNEL, data, length);
+}
+
+
+uint8_t SWUART_txFree(void)
+{
+	return SWUART_channelTxFree(SWUART_DEFAULT_CHANNEL);
+}
+
+
+uint8_t SWUART_txIdle(void)
+{
+	return SWUART_channelTxIdle(SWUART_DEFAULT_CHANNEL);
+}
+
+
+uint8_t SWUART_available(void)
+{
+	return SWUART_channelAvailable(SWUART_DEFAULT_CHANNEL);
+}
+
+
+uint16_t SWUART_rxGlitches(void)
+{
+	return SWUART_channelRxGlitches(SWUART_DEFAULT_CHANNEL);
+}
+
+
+void SWUART_getStats(ST_SWUART_stats_t *stats)
+{
+	SWUART_channelGetStats(SWUART_DEFAULT_CHANNEL, stats);
+}
+
+
+void SWUART_resetStats(void)
+{
+	SWUART_channelResetStats(SWUART_DEFAULT_CHANNEL);
+}
+
+
+#if SWUART_FLOW_CONTROL
+En_SWUART_Error_t SWUART_setFlowControl(uint8_t flowControl, uint8_t port, uint8_t rtsPin, uint8_t ctsPin)
+{
+	return SWUART_channelSetFlowControl(SWUART_DEFAULT_CHANNEL, flowControl, port, rtsPin, ctsPin);
+}
+#endif
+
+
+#if SWUART_LINE_MODE
+En_SWUART_Error_t SWUART_setLineMode(SWUART_data_t *buffer0, SWUART_data_t *buffer1, uint8_t size, SWUART_data_t delimiter)
+{
+	return SWUART_channelSetLineMode(SWUART_DEFAULT_CHANNEL, buffer0, buffer1, size, delimiter);
+}
+
+
+En_SWUART_Error_t SWUART_tryReceiveLine(SWUART_data_t **line, uint8_t *length, uint8_t *status)
+{
+	return SWUART_channelTryReceiveLine(SWUART_DEFAULT_CHANNEL, line, length, status);
+}
+
+
+void SWUART_receiveLine(SWUART_data_t **line, uint8_t *length, uint8_t *status)
+{
+	SWUART_channelReceiveLine(SWUART_DEFAULT_CHANNEL, line, length, status);
+}
+
+
+void SWUART_releaseLine(void)
+{
+	SWUART_channelReleaseLine(SWUART_DEFAULT_CHANNEL);
+}
+#endif
+
+
+#if SWUART_DATA_BITS == 9
+En_SWUART_Error_t SWUART_setMultidrop(uint8_t enable, uint8_t address)
+{
+	return SWUART_channelSetMultidrop(SWUART_DEFAULT_CHANNEL, enable, address);
+}
+
+
+void SWUART_sendAddress(uint8_t address)
+{
+	SWUART_channelSendAddress(SWUART_DEFAULT_CHANNEL, address);
+}
+#endif
+
+
+SWUART_data_t SWUART_read(void)
+{
+	return SWUART_channelRead(SWUART_DEFAULT_CHANNEL);
+}
+
+
+void SWUART_recieve(SWUART_data_t *data)
+{
+	SWUART_channelReceive(SWUART_DEFAULT_CHANNEL, data);
+}
+
+
+En_SWUART_Error_t SWUART_tryReceive(SWUART_data_t *data)
+{
+	return SWUART_channelTryReceive(SWUART_DEFAULT_CHANNEL, data);
+}
+
+
+En_SWUART_Error_t SWUART_tryReceiveStatus(SWUART_data_t *data, uint8_t *status)
+{
+	return SWUART_channelTryReceiveStatus(SWUART_DEFAULT_CHANNEL, data, status);
+}
+
+
+En_SWUART_Error_t SWUART_receiveTimeout(SWUART_data_t *data, uint32_t ticks)
+{
+	return SWUART_channelReceiveTimeout(SWUART_DEFAULT_CHANNEL, data, ticks);
+}
+
+
+void SWUART_sendBuffer(const SWUART_data_t *data, uint16_t length)
+{
+	SWUART_channelSendBuffer(SWUART_DEFAULT_CHANNEL, data, length);
+}
+
+
+uint16_t SWUART_receiveBuffer(SWUART_data_t *data, uint16_t length, uint16_t timeout)
+{
+	return SWUART_channelReceiveBuffer(SWUART_DEFAULT_CHANNEL, data, length, timeout);
+}
+
+
+#if SWUART_LINE_MODE
+//puts a received byte of the line mode in the line being filled, and hands the line over at its end
+static void SWUART_lineReceive(volatile ST_SWUART_channel_t *ch, SWUART_data_t data, uint8_t status)
+{
+	//both buffers hold a line, the byte is dropped and the next line tells it
+	if(ch->lineFull)
+	{
+		ch->rxOverrun = 1;
+		ch->stats.overruns++;
+	}
+	else
+	{
+		if(ch->rxOverrun)
+		{
+			status |= SWUART_STATUS_OVERRUN;
+			ch->rxOverrun = 0;
+		}
+		ch->lineStatus |= status;
+		uint8_t end = data == ch->lineDelimiter;
+		if(!end)
+		{
+			ch->lineBuffers[ch->lineFill][ch->lineLength++] = data;
+			if(ch->lineLength == ch->lineSize)
+			{
+				ch->lineStatus |= SWUART_STATUS_LINE_OVERFLOW;
+				end = 1;
+			}
+		}
+		if(end)
+		{
+			if(ch->lineReady)
+			{
+				ch->lineFull = 1;
+			}
+			else
+			{
+				SWUART_linePublish(ch);
+			}
+		}
+	}
+}
+#endif
+
+
+//checks the received frame, counts it and puts its data with its status in the receive buffer
+static void SWUART_rxComplete(volatile ST_SWUART_channel_t *ch, uint16_t frame)
+{
+	SWUART_data_t data = SWUART_RX_DATA(frame);
+	uint8_t status = SWUART_STATUS_OK;
+#if SWUART_HALF_DUPLEX
+	//a half-duplex channel receives its own frames
+	if(ch->txEcho)
+	{
+		ch->txEcho = 0;
+		return;
+	}
+#endif
+	ch->stats.rxFrames++;
+#if SWUART_PARITY != SWUART_PARITY_NONE
+	if(SWUART_RX_PARITY(frame) != SWUART_PARITY_BIT(data))
+	{
+		status |= SWUART_STATUS_PARITY_ERROR;
+		ch->stats.parityErrors++;
+	}
+#endif
+	if(!SWUART_RX_STOP(frame))
+	{
+		status |= SWUART_STATUS_FRAMING_ERROR;
+		ch->stats.framingErrors++;
+	}
+	if(status == SWUART_STATUS_OK)
+	{
+		ch->stats.rxFramesOk++;
+#if SWUART_HALF_DUPLEX
+		//after a good frame every receiver on a half-duplex bus waits for the next start bit
+		if(ch->halfDuplex)
+		{
+			ch->txIdleBits = SWUART_STOP_FRAME_BITS;
+		}
+#endif
+	}
+	if(ch->rxNoise)
+	{
+		status |= SWUART_STATUS_NOISE;
+		ch->stats.noisyFrames++;
+	}
+#if SWUART_CLOCK_TRACKING
+	//a timed frame is added to the clock tracking only if it was received without errors,
+	//a noisy one is kept, the samples of a drifting clock are the first to disagree
+	if(ch->rxOnInt0 && SWUART_globalTrackState == SWUART_TRACK_EDGE)
+	{
+		if((status & (SWUART_STATUS_PARITY_ERROR|SWUART_STATUS_FRAMING_ERROR)) == 0
+			&& SWUART_globalTrackFrames < SWUART_CLOCK_TRACK_FRAMES)
+		{
+			SWUART_globalTrackCounts += SWUART_globalTrackSpan;
+			SWUART_globalTrackFrames++;
+		}
+		SWUART_globalTrackState = SWUART_TRACK_IDLE;
+	}
+#endif
+#if SWUART_DATA_BITS == 9
+	//an address frame selects or deselects the node, the frames for the other nodes end here
+	if(ch->multidrop)
+	{
+		if(data & SWUART_ADDRESS_MARK)
+		{
+			ch->addressed = (status & (SWUART_STATUS_PARITY_ERROR | SWUART_STATUS_FRAMING_ERROR)) == 0
+				&& (uint8_t)data == ch->nodeAddress;
+		}
+		if(!ch->addressed)
+		{
+			return;
+		}
+	}
+#endif
+#if SWUART_FLOW_CONTROL
+	//the flow control bytes of the peer act at once and aren't data
+	if((ch->flowControl & SWUART_FLOW_XON_XOFF) && (status & (SWUART_STATUS_PARITY_ERROR | SWUART_STATUS_FRAMING_ERROR)) == 0
+		&& (data == SWUART_XON || data == SWUART_XOFF))
+	{
+		ch->txStopped = data == SWUART_XOFF;
+#if SWUART_TX_MODE == SWUART_TX_BIT_SLICED
+		if(ch->txSliced)
+		{
+			SWUART_globalTxGroups[ch->txPort - A].pending = 1;
+		}
+#endif
+		return;
+	}
+#endif
+#if SWUART_LINE_MODE
+	if(ch->lineSize != 0)
+	{
+		SWUART_lineReceive(ch, data, status);
+		return;
+	}
+#endif
+	uint8_t nextHead = (ch->rxHead+1) & SWUART_RX_BUFFER_MASK;
+	//the byte is dropped if the application didn't read the buffer in time, the next one tells it
+	if(nextHead == ch->rxTail)
+	{
+		ch->rxOverrun = 1;
+		ch->stats.overruns++;
+	}
+	else
+	{
+		if(ch->rxOverrun)
+		{
+			status |= SWUART_STATUS_OVERRUN;
+			ch->rxOverrun = 0;
+		}
+		ch->rxBuffer[ch->rxHead] = data;
+		ch->rxStatus[ch->rxHead] = status;
+		ch->rxHead = nextHead;
+		uint8_t used = (nextHead - ch->rxTail) & SWUART_RX_BUFFER_MASK;
+		if(used > ch->stats.maxRxUsed)
+		{
+			ch->stats.maxRxUsed = used;
+		}
+#if SWUART_FLOW_CONTROL
+		if(used >= SWUART_RX_HIGH_WATERMARK && ch->flowControl != SWUART_FLOW_NONE && !ch->rxThrottled)
+		{
+			SWUART_rxThrottle(ch, 1);
+		}
+#endif
+	}
+}
+
+
+static void SWUART_rxStart(volatile ST_SWUART_channel_t *ch, uint8_t ticks)
+{
+	ch->rxFrame = 0;
+	ch->rxTicks = ticks;
+	ch->rxBitsLeft = SWUART_RX_STEPS;
+	ch->rxWindowLeft = SWUART_RX_WINDOW;
+	ch->rxSamples = 0;
+	ch->rxNoise = 0;
+}
+
+
+#if SWUART_CLOCK_TRACKING
+//INT0 timestamps the next rising edge for the clock tracking, a low line means it is the end of the current bit,
+//a flag left by the edges of the data bits comes while the line is still low and is ignored by the ISR
+static void SWUART_trackArm(void)
+{
+	setBit(MCUCR,ISC00);
+	if(!DIO_READ_PIN(SWUART_INT0_PORT, SWUART_INT0_PIN))
+	{
+		SWUART_globalTrackState = SWUART_TRACK_ARMED;
+		setBit(GICR,INT0);
+	}
+	else
+	{
+		clrBit(MCUCR,ISC00);
+	}
+}
+
+
+//an edge that wasn't timed isn't waited anymore, INT0 goes back to the falling edge
+static void SWUART_trackDisarm(void)
+{
+	if(SWUART_globalTrackState == SWUART_TRACK_ARMED)
+	{
+		clrBit(GICR,INT0);
+		clrBit(MCUCR,ISC00);
+		SWUART_globalTrackState = SWUART_TRACK_IDLE;
+	}
+}
+#endif
+
+
+//the receiver waits for the next start bit
+static void SWUART_rxIdle(volatile ST_SWUART_channel_t *ch)
+{
+	ch->rxBitsLeft = 0;
+#if SWUART_RX_INT0
+	if(ch->rxOnInt0)
+	{
+#if SWUART_CLOCK_TRACKING
+		SWUART_trackDisarm();
+#endif
+		setBit(GICR,INT0);
+	}
+#endif
+}
+
+
+ISR(EXT_INT0)
+{
+	if(SWUART_globalAutoBaud)
+	{
+		uint8_t count = SWUART_globalAutoBaudCount;
+		uint8_t index = count & SWUART_AUTOBAUD_EDGES_MASK;
+		SWUART_globalAutoBaudEdges[index] = Timer0_getTicks();
+		if(DIO_READ_PIN(SWUART_INT0_PORT, SWUART_INT0_PIN))
+		{
+			SWUART_globalAutoBaudLevels |= 1U<<index;
+		}
+		else
+		{
+			SWUART_globalAutoBaudLevels &= ~(1U<<index);
+		}
+		//the count stays at least SWUART_AUTOBAUD_EDGES once the buffer is full, with the same index
+		if(++count == 2*SWUART_AUTOBAUD_EDGES)
+		{
+			count = SWUART_AUTOBAUD_EDGES;
+		}
+		SWUART_globalAutoBaudCount = count;
+	}
+#if SWUART_RX_INT0
+	else if(SWUART_globalInt0Channel != SWUART_NO_CHANNEL)
+	{
+		volatile ST_SWUART_channel_t *ch = &SWUART_globalChannels[SWUART_globalInt0Channel];
+#if SWUART_CLOCK_TRACKING
+		//both edges of a timed frame are timestamped first, so the latency of the ISR cancels out
+		uint32_t ticks = SWUART_globalClockTracking ? Timer0_getTicks() : 0;
+		if(SWUART_globalTrackState == SWUART_TRACK_ARMED)
+		{
+			//a flag left pending by the falling edges of the frame comes while the line is still low
+			if(DIO_READ_PIN(SWUART_INT0_PORT, SWUART_INT0_PIN))
+			{
+				SWUART_globalTrackSpan = ticks - SWUART_globalTrackStart;
+				SWUART_globalTrackState = SWUART_TRACK_EDGE;
+				//back to the falling edge, enabled again after the stop bit
+				clrBit(GICR,INT0);
+				clrBit(MCUCR,ISC00);
+			}
+		}
+		else
+#endif
+		//ignore edges left pending from the data bits of the previous frame
+		if(ch->rxBitsLeft == 0 && !DIO_READ_PIN(SWUART_INT0_PORT, SWUART_INT0_PIN))
+		{
+			SWUART_rxStart(ch, ch->rxFirstSample);
+#if SWUART_CLOCK_TRACKING
+			SWUART_globalTrackStart = ticks;
+			SWUART_globalTrackState = SWUART_TRACK_IDLE;
+#endif
+			//no more edges are needed until the stop bit
+			clrBit(GICR,INT0);
+		}
+	}
+#endif
+}
+
+
+//puts a bit on the TX pin, a half-duplex channel drives only the low bits
+static void SWUART_txWrite(volatile ST_SWUART_channel_t *ch, uint8_t level)
+{
+#if SWUART_HALF_DUPLEX
+	if(ch->halfDuplex)
+	{
+		//the pin goes through input without pull up, so it is never driven high
+		if(level)
+		{
+			DIO_writeFast(ch->txDirAddress, ch->txMask, IN);
+			DIO_writeFast(ch->txAddress, ch->txMask, HIGH);
+		}
+		else
+		{
+			DIO_writeFast(ch->txAddress, ch->txMask, LOW);
+			DIO_writeFast(ch->txDirAddress, ch->txMask, OUT);
+		}
+		ch->txLevel = level;
+	}
+	else
+#endif
+	{
+		DIO_writeFast(ch->txAddress, ch->txMask, level);
+	}
+}
+
+
+//takes the next byte in txData: a flow control byte first, then the transmit buffer while the peer lets it,
+//returns 0 if there is nothing to send
+static uint8_t SWUART_txTake(volatile ST_SWUART_channel_t *ch)
+{
+	uint8_t taken = 1;
+#if SWUART_FLOW_CONTROL
+	if(ch->txFlowChar != 0)
+	{
+		ch->txData = ch->txFlowChar;
+		ch->txFlowChar = 0;
+	}
+	else if(ch->txHead != ch->txTail && !ch->txStopped
+		&& !((ch->flowControl & SWUART_FLOW_RTS_CTS) && DIO_readFast(ch->ctsAddress, ch->ctsMask)))
+#else
+	if(ch->txHead != ch->txTail)
+#endif
+	{
+		ch->txData = ch->txBuffer[ch->txTail];
+		ch->txTail = (ch->txTail+1) & SWUART_TX_BUFFER_MASK;
+	}
+	else
+	{
+		taken = 0;
+	}
+	if(taken)
+	{
+#if SWUART_HALF_DUPLEX
+		ch->txRetries = SWUART_COLLISION_RETRIES;
+#endif
+		ch->stats.txFrames++;
+	}
+	return taken;
+}
+
+
+//builds the frame of txData, the byte taken or the byte to send again after a collision
+static void SWUART_txLoad(volatile ST_SWUART_channel_t *ch)
+{
+	ch->txFrame = SWUART_buildFrame(ch->txData);
+	ch->txBitsLeft = SWUART_FRAME_BITS;
+#if SWUART_HALF_DUPLEX
+	ch->txResend = 0;
+	ch->txEcho = ch->halfDuplex;
+#endif
+}
+
+
+#if SWUART_HALF_DUPLEX
+//another node drove the line low on a high bit, the frame is stopped and left to the receiver
+static void SWUART_txCollision(volatile ST_SWUART_channel_t *ch)
+{
+	SWUART_txWrite(ch, HIGH);
+	ch->txBitsLeft = 0;
+	ch->txEcho = 0;
+	ch->stats.collisions++;
+	if(ch->txRetries != 0)
+	{
+		ch->txRetries--;
+		ch->txResend = 1;
+	}
+	else
+	{
+		ch->stats.txDropped++;
+	}
+}
+#endif
+
+
+//transmitter, one bit every ticksPerBit ticks
+static void SWUART_txTick(volatile ST_SWUART_channel_t *ch)
+{
+	if(--ch->txTicks == 0)
+	{
+		ch->txTicks = ch->ticksPerBit;
+		//the bit on the line is done, txBitsLeft counts the bits not done yet
+#if SWUART_HALF_DUPLEX
+		if(ch->txBitsLeft != 0 && --ch->txBitsLeft == 0)
+		{
+			//the echo was received in the middle of the first stop bit, a missed one doesn't drop the next frame
+			ch->txEcho = 0;
+		}
+		//a half-duplex channel waits until the line was high for a whole frame, so no receiver on the bus is in a frame
+		if(ch->halfDuplex && ch->txBitsLeft == 0)
+		{
+			if(ch->rxBitsLeft != 0 || !DIO_readFast(ch->rxAddress, ch->rxMask))
+			{
+				ch->txIdleBits = SWUART_FRAME_BITS;
+			}
+			else if(ch->txIdleBits != 0)
+			{
+				ch->txIdleBits--;
+			}
+		}
+		//load the next frame when the last stop bit is done, so frames go back to back
+		if(ch->txBitsLeft == 0 && ch->txIdleBits == 0 && (ch->txResend || SWUART_txTake(ch)))
+#else
+		if(ch->txBitsLeft != 0)
+		{
+			ch->txBitsLeft--;
+		}
+		//load the next frame when the last stop bit is done, so frames go back to back
+		if(ch->txBitsLeft == 0 && SWUART_txTake(ch))
+#endif
+		{
+			SWUART_txLoad(ch);
+		}
+		if(ch->txBitsLeft != 0)
+		{
+			SWUART_txWrite(ch, ch->txFrame & 0x01);
+			ch->txFrame >>= 1;
+#if SWUART_STOP_BITS == SWUART_STOP_BITS_1_5
+			//the last stop bit is half a bit
+			if(ch->txBitsLeft == 1)
+			{
+				ch->txTicks = (ch->ticksPerBit+1)>>1;
+			}
+#endif
+		}
+	}
+#if SWUART_HALF_DUPLEX
+	//a half-duplex channel reads back the bits before the stop bits (ticksPerBit+1)/2 ticks after their edge,
+	//on the tick the receiver samples the middle of a bit, so a peer a bit late is read in the same bit
+	else if(ch->halfDuplex && ch->txBitsLeft > SWUART_STOP_FRAME_BITS && ch->txTicks == ch->ticksPerBit>>1
+		&& DIO_readFast(ch->rxAddress, ch->rxMask) != ch->txLevel)
+	{
+		SWUART_txCollision(ch);
+	}
+#endif
+}
+
+
+//receiver, sampling around the middle of each bit after the start edge
+static void SWUART_rxTick(volatile ST_SWUART_channel_t *ch)
+{
+	uint8_t bitValue = 0;
+	if(ch->rxBitsLeft == 0)
+	{
+		//without INT0 the start bit is polled, the edge was up to one tick ago like the first tick counted after INT0
+#if SWUART_RX_INT0
+		if(!ch->rxOnInt0 && !DIO_readFast(ch->rxAddress, ch->rxMask))
+#else
+		if(!DIO_readFast(ch->rxAddress, ch->rxMask))
+#endif
+		{
+			SWUART_rxStart(ch, ch->rxFirstSample-1);
+		}
+	}
+	else if(--ch->rxTicks == 0)
+	{
+		bitValue = DIO_readFast(ch->rxAddress, ch->rxMask);
+		ch->rxTicks = 1;
+#if SWUART_RX_MODE == SWUART_RX_MAJORITY_VOTE
+		if(ch->rxBitsLeft == SWUART_RX_STEPS)
+		{
+			//a start bit that is high again in its middle was a glitch
+			if(bitValue)
+			{
+				ch->stats.glitches++;
+				SWUART_rxIdle(ch);
+			}
+			else
+			{
+				ch->rxBitsLeft--;
+				ch->rxTicks = ch->rxFirstWindow;
+			}
+			return;
+		}
+#endif
+		ch->rxSamples = (ch->rxSamples<<1) | bitValue;
+#if SWUART_CLOCK_TRACKING
+		//the bit before the stop bit is armed at its first sample, the edge of a fast peer may come before the vote
+		if(SWUART_globalClockTracking && ch->rxBitsLeft == 2 && ch->rxWindowLeft == SWUART_RX_WINDOW && !bitValue
+			&& ch->rxOnInt0)
+		{
+			SWUART_trackArm();
+		}
+#endif
+		if(--ch->rxWindowLeft == 0)
+		{
+			bitValue = SWUART_RX_VOTE(ch->rxSamples);
+#if SWUART_RX_MODE == SWUART_RX_MAJORITY_VOTE
+			ch->rxNoise |= SWUART_RX_NOISE(ch->rxSamples);
+#endif
+			ch->rxTicks = ch->rxNextWindow;
+			ch->rxWindowLeft = SWUART_RX_WINDOW;
+			ch->rxSamples = 0;
+#if SWUART_BIT_ORDER == SWUART_LSB_FIRST
+			ch->rxFrame = (ch->rxFrame>>1) | ((uint16_t)bitValue<<(SWUART_RX_SAMPLES-1));
+#else
+			ch->rxFrame = (ch->rxFrame<<1) | bitValue;
+#endif
+			if(--ch->rxBitsLeft == 0)
+			{
+				SWUART_rxComplete(ch, ch->rxFrame);
+				SWUART_rxIdle(ch);
+			}
+#if SWUART_CLOCK_TRACKING
+			//only a low bit before the stop bit ends with the timed rising edge
+			else if(SWUART_globalClockTracking && ch->rxBitsLeft == 1 && ch->rxOnInt0)
+			{
+				if(bitValue)
+				{
+					SWUART_trackDisarm();
+					SWUART_globalTrackState = SWUART_TRACK_IDLE;
+				}
+				else if(SWUART_globalTrackState == SWUART_TRACK_IDLE)
+				{
+					SWUART_trackArm();
+				}
+			}
+#endif
+		}
+	}
+}
+
+
+#if SWUART_TX_MODE == SWUART_TX_BIT_SLICED
+//takes the next byte of every channel in the group and transposes their frames into the port masks
+static void SWUART_txGroupLoad(uint8_t port, volatile ST_SWUART_txGroup_t *group)
+{
+	uint8_t loaded = 0;
+	group->pending = 0;
+	//the pins without a frame stay idle high
+	for(uint8_t i = 0; i < SWUART_FRAME_BITS; i++)
+	{
+		group->masks[i] = group->pinMask;
+	}
+	for(uint8_t i = 0; i < SWUART_NUM_OF_CHANNELS; i++)
+	{
+		volatile ST_SWUART_channel_t *ch = &SWUART_globalChannels[i];
+		if(ch->open && ch->txSliced && ch->txPort == port)
+		{
+			ch->txBitsLeft = 0;
+			if(SWUART_txTake(ch))
+			{
+				uint16_t frame = SWUART_buildFrame(ch->txData);
+				ch->txBitsLeft = SWUART_FRAME_BITS;
+				uint8_t pin = 1<<ch->txPin;
+				for(uint8_t bit = 0; bit < SWUART_FRAME_BITS; bit++)
+				{
+					if(!(frame & 0x01))
+					{
+						group->masks[bit] &= ~pin;
+					}
+					frame >>= 1;
+				}
+				loaded = 1;
+			}
+#if SWUART_FLOW_CONTROL
+			//a byte held by the flow control is looked at again on the next bit time
+			else if(ch->txHead != ch->txTail)
+			{
+				group->pending = 1;
+			}
+#endif
+		}
+	}
+	if(loaded)
+	{
+		group->bitsLeft = SWUART_FRAME_BITS;
+	}
+}
+
+
+//transmitter of a group, one port write every ticksPerBit ticks whatever the number of channels
+static void SWUART_txGroupTick(uint8_t port, volatile ST_SWUART_txGroup_t *group)
+{
+	if(--group->ticks == 0)
+	{
+		group->ticks = group->ticksPerBit;
+		//the next frames are loaded when the last stop bits are done, so frames go back to back
+		if(group->bitsLeft != 0)
+		{
+			if(--group->bitsLeft == 0)
+			{
+				SWUART_txGroupLoad(port, group);
+			}
+		}
+		else if(group->pending)
+		{
+			SWUART_txGroupLoad(port, group);
+		}
+		if(group->bitsLeft != 0)
+		{
+			DIO_writePortFast(PORT_ADDRESS(port), group->pinMask, group->masks[SWUART_FRAME_BITS - group->bitsLeft]);
+#if SWUART_STOP_BITS == SWUART_STOP_BITS_1_5
+			if(group->bitsLeft == 1)
+			{
+				group->ticks = (group->ticksPerBit+1)>>1;
+			}
+#endif
+		}
+	}
+}
+#endif
+
+
+//the bit clock, called by the timer service on every compare match
+static void SWUART_tick(void)
+{
+	SWUART_globalTicks++;
+#if SWUART_TX_MODE == SWUART_TX_BIT_SLICED
+	//all the TX pins of a port first, so their edges come together
+	for(uint8_t i = 0; i < SWUART_NUM_OF_PORTS; i++)
+	{
+		volatile ST_SWUART_txGroup_t *group = &SWUART_globalTxGroups[i];
+		if(group->pinMask != 0)
+		{
+			SWUART_txGroupTick(A + i, group);
+		}
+	}
+#endif
+	//one tick serves all the open channels
+	for(uint8_t i = 0; i < SWUART_NUM_OF_CHANNELS; i++)
+	{
+		volatile ST_SWUART_channel_t *ch = &SWUART_globalChannels[i];
+		if(ch->open)
+		{
+			if(!ch->txSliced)
+			{
+				SWUART_txTick(ch);
+			}
+			SWUART_rxTick(ch);
+		}
 	}
 }
 
 
-//////////////////////////////////////////////////////////
\ No newline at end of file
+//////////////////////////////////////////////////////////
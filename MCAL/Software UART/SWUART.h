@@ -0,0 +1,784 @@
+
+
+
+
+
+#ifndef SWUART_H_
+#define SWUART_H_
+
+#include"Dio.h"
+#include "TimerService.h"
+
+
+
+
+
+//############# SWUART.h ##############
+
+//pins of the default channel, opened by SWUART_init
+#define TX 0
+#define UART_PORT A
+//RX on the INT0 pin (PD2) detects the start bit by its falling edge, which auto-baud needs
+#define RX 2
+#define UART_RX_PORT D
+
+
+/*
+ * Status flags of a received frame, returned with its data by SWUART_channelTryReceiveStatus.
+ * SWUART_STATUS_PARITY_ERROR: the parity bit doesn't match the data bits.
+ * SWUART_STATUS_FRAMING_ERROR: the first stop bit was low.
+ * SWUART_STATUS_OVERRUN: frames were dropped before this one because the receive buffer was full.
+ * SWUART_STATUS_NOISE: the samples of a bit didn't all agree, only in the SWUART_RX_MAJORITY_VOTE mode.
+ * SWUART_STATUS_LINE_OVERFLOW: only for a line of the line mode, it filled its buffer before the delimiter
+ * and the rest of it starts the next line.
+ * In the line mode a line has the flags of all its bytes, and SWUART_STATUS_OVERRUN if bytes were dropped before it.
+ */
+#define SWUART_STATUS_OK			0x00
+#define SWUART_STATUS_PARITY_ERROR	0x01
+#define SWUART_STATUS_FRAMING_ERROR	0x02
+#define SWUART_STATUS_OVERRUN		0x04
+#define SWUART_STATUS_NOISE			0x08
+#define SWUART_STATUS_LINE_OVERFLOW	0x10
+
+/*
+ * Frame format, the same for all the channels and fixed at compile time,
+ * so the ISR has no branches for the parts of the frame that aren't used.
+ * The defaults are the original format of the driver: 8 data bits MSB first, even parity and 2 stop bits.
+ */
+
+/*
+ * Number of data bits in a frame, 5 to 9.
+ * With 9 data bits the data of the send and receive functions is 16 bit, see SWUART_data_t.
+ */
+#ifndef SWUART_DATA_BITS
+#define SWUART_DATA_BITS 8
+#endif
+#if SWUART_DATA_BITS < 5 || SWUART_DATA_BITS > 9
+#error "SWUART_DATA_BITS must be 5 to 9"
+#endif
+
+/*
+ * Parity bit modes, selected by SWUART_PARITY.
+ * SWUART_PARITY_NONE: no parity bit, SWUART_STATUS_PARITY_ERROR is never reported.
+ * SWUART_PARITY_EVEN, SWUART_PARITY_ODD: the parity bit makes the number of ones in the data and parity even or odd.
+ * SWUART_PARITY_MARK, SWUART_PARITY_SPACE: the parity bit is always 1 or always 0.
+ */
+#define SWUART_PARITY_NONE	0
+#define SWUART_PARITY_EVEN	1
+#define SWUART_PARITY_ODD	2
+#define SWUART_PARITY_MARK	3
+#define SWUART_PARITY_SPACE	4
+#ifndef SWUART_PARITY
+#define SWUART_PARITY SWUART_PARITY_EVEN
+#endif
+#if SWUART_PARITY < SWUART_PARITY_NONE || SWUART_PARITY > SWUART_PARITY_SPACE
+#error "SWUART_PARITY must be one of the SWUART_PARITY_ modes"
+#endif
+
+/*
+ * Number of stop bits sent after every frame, 1, 2 or SWUART_STOP_BITS_1_5.
+ * The next frame starts right after them, and the receiver checks only the first one.
+ * The half stop bit of SWUART_STOP_BITS_1_5 is rounded up to whole ticks, it is exact with an even SWUART_TICKS_PER_BIT.
+ */
+#define SWUART_STOP_BITS_1_5 3
+#ifndef SWUART_STOP_BITS
+#define SWUART_STOP_BITS 2
+#endif
+#if SWUART_STOP_BITS != 1 && SWUART_STOP_BITS != 2 && SWUART_STOP_BITS != SWUART_STOP_BITS_1_5
+#error "SWUART_STOP_BITS must be 1, 2 or SWUART_STOP_BITS_1_5"
+#endif
+
+/*
+ * Order of the data bits on the line, selected by SWUART_BIT_ORDER.
+ */
+#define SWUART_LSB_FIRST	0
+#define SWUART_MSB_FIRST	1
+#ifndef SWUART_BIT_ORDER
+#define SWUART_BIT_ORDER SWUART_MSB_FIRST
+#endif
+
+#define SWUART_DATA_MASK	((1U<<SWUART_DATA_BITS)-1)
+#if SWUART_PARITY == SWUART_PARITY_NONE
+#define SWUART_PARITY_BITS	0
+#else
+#define SWUART_PARITY_BITS	1
+#endif
+//the half stop bit takes a whole bit of the frame, only its time is shorter
+#if SWUART_STOP_BITS == SWUART_STOP_BITS_1_5
+#define SWUART_STOP_FRAME_BITS	2
+#else
+#define SWUART_STOP_FRAME_BITS	SWUART_STOP_BITS
+#endif
+
+//number of bits in a frame on the line: start bit + data bits + parity bit + stop bits
+#define SWUART_FRAME_BITS (1+SWUART_DATA_BITS+SWUART_PARITY_BITS+SWUART_STOP_FRAME_BITS)
+
+/*
+ * Data of one frame as the send and receive functions take it, a byte up to 8 data bits.
+ */
+#if SWUART_DATA_BITS > 8
+typedef uint16_t SWUART_data_t;
+#else
+typedef uint8_t SWUART_data_t;
+#endif
+
+/*
+ * With 9 data bits the 9th one marks an address frame of a multidrop bus, like the multi-processor
+ * communication mode (MPCM) of the USART: the low 8 bits are the address of the node the next data frames are for.
+ */
+#if SWUART_DATA_BITS == 9
+#define SWUART_ADDRESS_MARK	0x100
+#endif
+
+//timeout of SWUART_receiveBuffer that waits until all the bytes are received
+#define SWUART_NO_TIMEOUT 0xFFFF
+
+/*
+ * Number of channels, all served by the one Timer 0 tick. Every channel has its own buffers.
+ * Channel SWUART_DEFAULT_CHANNEL is the one used by the functions without a channel argument.
+ */
+#ifndef SWUART_NUM_OF_CHANNELS
+#define SWUART_NUM_OF_CHANNELS 1
+#endif
+#define SWUART_DEFAULT_CHANNEL 0
+
+/*
+ * Size of the transmit ring buffer of a channel in bytes.
+ * It must be a power of 2 and not more than 128, one slot is always kept empty to tell full from empty.
+ */
+#ifndef SWUART_TX_BUFFER_SIZE
+#define SWUART_TX_BUFFER_SIZE 32
+#endif
+
+/*
+ * Size of the receive ring buffer of a channel in bytes, with the same rules as SWUART_TX_BUFFER_SIZE.
+ */
+#ifndef SWUART_RX_BUFFER_SIZE
+#define SWUART_RX_BUFFER_SIZE 32
+#endif
+
+/*
+ * Number of Timer 0 compare matches per bit time.
+ * The receiver starts counting on the start bit edge, so its sampling point is off the middle of the bit by up to half a tick.
+ * It must be at least 2, with 1 the sample lands on the bit edge, and at least 3 in the SWUART_RX_MAJORITY_VOTE mode.
+ */
+#ifndef SWUART_TICKS_PER_BIT
+#define SWUART_TICKS_PER_BIT 3
+#endif
+
+/*
+ * Receiver sampling modes, selected by SWUART_RX_MODE.
+ * SWUART_RX_SINGLE_SAMPLE: every bit is sampled once, in its middle.
+ * SWUART_RX_MAJORITY_VOTE: the start bit is confirmed in its middle, then every bit is sampled on 3 consecutive
+ * ticks around its middle and takes the majority, SWUART_TICKS_PER_BIT must be 3 or more.
+ * A higher SWUART_TICKS_PER_BIT keeps the 3 samples closer to the middle of the bit.
+ */
+#define SWUART_RX_SINGLE_SAMPLE	0
+#define SWUART_RX_MAJORITY_VOTE	1
+#ifndef SWUART_RX_MODE
+#define SWUART_RX_MODE SWUART_RX_MAJORITY_VOTE
+#endif
+
+/*
+ * Transmitter modes, selected by SWUART_TX_MODE.
+ * SWUART_TX_PER_PIN: every channel writes its own TX pin on its bits.
+ * SWUART_TX_BIT_SLICED: the channels with their TX pins on the same port and the same baudrate are a group,
+ * their next bytes are transposed into one port mask per bit of the frame when the frames in flight end,
+ * and every bit is one write of the port, so all their edges come together and a bit costs the same for 1 to 8 channels.
+ * A channel with another baudrate on a port that already has a group sends by itself like SWUART_TX_PER_PIN.
+ */
+#define SWUART_TX_PER_PIN		0
+#define SWUART_TX_BIT_SLICED	1
+#ifndef SWUART_TX_MODE
+#define SWUART_TX_MODE SWUART_TX_BIT_SLICED
+#endif
+
+/*
+ * Optional features, fixed at compile time like the frame format, so the ISR of an application that doesn't use
+ * a feature has none of its checks and the channels none of its fields. 1 compiles the feature in, 0 leaves it out.
+ * SWUART_RX_INT0: a channel with RX on the INT0 pin detects the start bit by its falling edge,
+ * without it RX is polled every tick on every pin. Auto-baud and the calibration use INT0 either way.
+ * SWUART_HALF_DUPLEX: SWUART_openHalfDuplex and the collision detection.
+ * SWUART_FLOW_CONTROL: SWUART_channelSetFlowControl, RTS/CTS and XON/XOFF.
+ * SWUART_LINE_MODE: SWUART_channelSetLineMode and the line functions.
+ * SWUART_CLOCK_TRACKING: SWUART_setClockTracking and SWUART_trackClock, it needs SWUART_RX_INT0.
+ * The start bit detection by INT0 is on by default, as in the original driver, the other features are off.
+ */
+#ifndef SWUART_RX_INT0
+#define SWUART_RX_INT0 1
+#endif
+#ifndef SWUART_HALF_DUPLEX
+#define SWUART_HALF_DUPLEX 0
+#endif
+#ifndef SWUART_FLOW_CONTROL
+#define SWUART_FLOW_CONTROL 0
+#endif
+#ifndef SWUART_LINE_MODE
+#define SWUART_LINE_MODE 0
+#endif
+#ifndef SWUART_CLOCK_TRACKING
+#define SWUART_CLOCK_TRACKING 0
+#endif
+#if SWUART_CLOCK_TRACKING && !SWUART_RX_INT0
+#error "SWUART_CLOCK_TRACKING times the frames with INT0, it needs SWUART_RX_INT0"
+#endif
+
+/*
+ * Byte the peer sends to let the auto-baud detection measure the bit time.
+ * The edges of its frame up to the first stop bit are timestamped and must all fit the frame of this byte,
+ * so a break sent before it (LIN style) or other bytes are ignored.
+ */
+#ifndef SWUART_SYNC_BYTE
+#define SWUART_SYNC_BYTE 0x55
+#endif
+
+/*
+ * Clock calibration, for a system clock that isn't SYSTEM_CLK, like the internal RC oscillator.
+ * A clock measured more than 1/SWUART_CLOCK_RANGE off SYSTEM_CLK is taken for a wrong pattern and ignored.
+ * The clock tracking measures SWUART_CLOCK_TRACK_FRAMES frames before every update.
+ */
+#ifndef SWUART_CLOCK_RANGE
+#define SWUART_CLOCK_RANGE 10
+#endif
+#if SWUART_CLOCK_TRACKING
+#ifndef SWUART_CLOCK_TRACK_FRAMES
+#define SWUART_CLOCK_TRACK_FRAMES 16
+#endif
+#endif
+
+/*
+ * Times a half-duplex channel sends a frame again after it lost the line to another node in a collision,
+ * then the frame is dropped.
+ */
+#if SWUART_HALF_DUPLEX
+#ifndef SWUART_COLLISION_RETRIES
+#define SWUART_COLLISION_RETRIES 3
+#endif
+#endif
+
+/*
+ * Flow control modes of a channel, set by SWUART_channelSetFlowControl, they can be combined.
+ * SWUART_FLOW_NONE: the bytes are sent whenever they are queued, and dropped with SWUART_STATUS_OVERRUN
+ * when the receive buffer is full.
+ * SWUART_FLOW_RTS_CTS: RTS is an output, low while the receive buffer has room, CTS is an input with pull up,
+ * a frame starts only while the peer holds it low. A frame already started is sent to its end.
+ * SWUART_FLOW_XON_XOFF: SWUART_XOFF is sent ahead of the queued bytes when the receive buffer fills up and
+ * SWUART_XON when it has room again, the received SWUART_XOFF and SWUART_XON stop and restart the transmitter
+ * and aren't put in the receive buffer, so the data must not contain these two bytes.
+ */
+#if SWUART_FLOW_CONTROL
+#define SWUART_FLOW_NONE		0x00
+#define SWUART_FLOW_RTS_CTS		0x01
+#define SWUART_FLOW_XON_XOFF	0x02
+#define SWUART_XON				0x11
+#define SWUART_XOFF				0x13
+
+/*
+ * Receive buffer levels of the flow control: the peer is stopped when SWUART_RX_HIGH_WATERMARK bytes are waiting
+ * and restarted when the application has read them down to SWUART_RX_LOW_WATERMARK.
+ * The free places above the high watermark take the frames the peer sends before it stops,
+ * one with RTS/CTS, a few with XON/XOFF as SWUART_XOFF waits for the frame in flight of this channel.
+ */
+#ifndef SWUART_RX_HIGH_WATERMARK
+#define SWUART_RX_HIGH_WATERMARK (SWUART_RX_BUFFER_SIZE*3/4)
+#endif
+#ifndef SWUART_RX_LOW_WATERMARK
+#define SWUART_RX_LOW_WATERMARK (SWUART_RX_BUFFER_SIZE/4)
+#endif
+#if SWUART_RX_LOW_WATERMARK >= SWUART_RX_HIGH_WATERMARK || SWUART_RX_HIGH_WATERMARK >= SWUART_RX_BUFFER_SIZE
+#error "the flow control needs SWUART_RX_LOW_WATERMARK < SWUART_RX_HIGH_WATERMARK < SWUART_RX_BUFFER_SIZE"
+#endif
+#endif
+
+/*
+ * Link statistics of a channel, counted since it was opened or since SWUART_channelResetStats.
+ */
+typedef struct
+{
+	uint32_t txFrames;		/* frames sent */
+	uint32_t rxFrames;		/* frames received, with or without errors and dropped or not */
+	uint32_t rxFramesOk;	/* frames received without parity and framing errors */
+	uint16_t parityErrors;	/* frames received with SWUART_STATUS_PARITY_ERROR */
+	uint16_t framingErrors;	/* frames received with SWUART_STATUS_FRAMING_ERROR */
+	uint16_t overruns;		/* frames dropped because the receive buffer was full */
+	uint16_t noisyFrames;	/* frames received with SWUART_STATUS_NOISE */
+	uint16_t glitches;		/* start edges rejected by the receiver */
+	uint16_t collisions;	/* frames a half-duplex channel stopped sending because another node drove the line, 0 without SWUART_HALF_DUPLEX */
+	uint16_t txDropped;		/* frames dropped after SWUART_COLLISION_RETRIES collisions */
+	uint8_t maxTxUsed;		/* most bytes waiting in the transmit buffer */
+	uint8_t maxRxUsed;		/* most bytes waiting in the receive buffer */
+}ST_SWUART_stats_t;
+
+/*
+ * Status values returned by the non-blocking SW UART functions.
+ */
+typedef enum
+{
+	SWUART_OK,				/* the request was done */
+	SWUART_TX_BUFFER_FULL,	/* there is no free space in the transmit buffer */
+	SWUART_AUTOBAUD_PENDING,	/* the sync byte hasn't been detected yet */
+	SWUART_WRONG_CHANNEL,	/* the channel number is out of range or the channel isn't open */
+	SWUART_WRONG_PIN,		/* the port or a pin number is out of range */
+	SWUART_WRONG_BAUDRATE,	/* the baudrate can't be generated from the tick */
+	SWUART_NO_DATA,			/* there is no received data in the receive buffer */
+	SWUART_TIMEOUT			/* nothing was received before the deadline */
+}En_SWUART_Error_t;
+
+/*
+ * baudrate: is an input argument that describes baudrate that the UART needs to make the communications.
+ * It closes all the channels and opens SWUART_DEFAULT_CHANNEL on TX of UART_PORT and RX of UART_RX_PORT.
+ * Timer 0 runs as a free running timebase with a periodic compare match SWUART_TICKS_PER_BIT times every bit time,
+ * the bits are shifted out and sampled from its compare match ISR.
+ * INT0 is configured to interrupt on the falling edge of the start bit.
+ */
+ void SWUART_init(uint32_t baudrate);
+
+/*
+ * channel: is an input argument that describes the channel number, less than SWUART_NUM_OF_CHANNELS.
+ * port: is an input argument that describes the port of both pins, A, B, C or D.
+ * txPin, rxPin: are input arguments that describe the pin numbers of TX and RX in the port.
+ * baudrate: is an input argument that describes the baudrate of the channel.
+ * It opens the channel with empty buffers, or opens it again with the new settings.
+ * The first channel opened sets the tick to baudrate*SWUART_TICKS_PER_BIT, the others count their bit time
+ * in whole ticks, so their baudrate must divide the tick to within 2% and not be above the first one.
+ * The start bit is detected on the falling edge if RX is the INT0 pin (PD2) and SWUART_RX_INT0 is set, otherwise RX is polled every tick.
+ * It returns SWUART_OK, SWUART_WRONG_CHANNEL, SWUART_WRONG_PIN or SWUART_WRONG_BAUDRATE.
+ */
+ En_SWUART_Error_t SWUART_open(uint8_t channel, uint8_t port, uint8_t txPin, uint8_t rxPin, uint32_t baudrate);
+
+#if SWUART_HALF_DUPLEX
+/*
+ * channel: is an input argument that describes the channel number.
+ * port, pin: are input arguments that describe the pin of the single-wire bus.
+ * baudrate: is an input argument that describes the baudrate of the channel.
+ * It opens the channel like SWUART_open with TX and RX on one open drain pin, for a bus shared by several nodes.
+ * The pin is an input pulled up, a low bit switches it to output low and a high bit releases it,
+ * so the line is released during the stop bits and between the frames.
+ * A frame is started only while the receiver is idle and the line is high. Every bit up to the stop bits is read back
+ * (SWUART_TICKS_PER_BIT+1)/2 ticks after its edge, where the receiver samples the middle of a bit, a released bit
+ * read low is a collision: the frame is stopped at once, the receiver goes on with the
+ * frame of the other node and the frame is sent again when the line is idle, up to SWUART_COLLISION_RETRIES times.
+ * The frames the channel sends aren't put in its receive buffer.
+ * It returns SWUART_OK, SWUART_WRONG_CHANNEL, SWUART_WRONG_PIN or SWUART_WRONG_BAUDRATE.
+ */
+ En_SWUART_Error_t SWUART_openHalfDuplex(uint8_t channel, uint8_t port, uint8_t pin, uint32_t baudrate);
+#endif
+
+/*
+ * channel: is an input argument that describes the channel number.
+ * It stops serving the channel, the tick is stopped when no channel is open.
+ */
+ void SWUART_close(uint8_t channel);
+
+/*
+ * It starts the auto-baud detection on the default channel, all the channels are closed.
+ * Timer 0 runs in normal mode and INT0 timestamps the edges on RX until the sync byte is detected.
+ */
+ void SWUART_autoBaudStart(void);
+ 
+/*
+ * baudrate: is an output argument that describes the detected baudrate.
+ * It returns at once with SWUART_AUTOBAUD_PENDING, or with SWUART_OK when the edges of SWUART_SYNC_BYTE were
+ * detected, then the driver is initialized by SWUART_init with the detected baudrate, which empties the buffers.
+ */
+ En_SWUART_Error_t SWUART_autoBaudDone(uint32_t *baudrate);
+ 
+/*
+ * It waits until the peer sends SWUART_SYNC_BYTE and returns its baudrate, the driver is initialized with it.
+ * The sync byte itself isn't put in the receive buffer.
+ */
+ uint32_t SWUART_autoBaud(void);
+
+/*
+ * baudrate: is an input argument that describes the known baudrate of the peer.
+ * It starts the clock calibration on the default channel like SWUART_autoBaudStart, the peer sends
+ * SWUART_SYNC_BYTE at the baudrate as the reference pattern.
+ */
+ void SWUART_calibrationStart(uint32_t baudrate);
+ 
+/*
+ * clock: is an output argument that describes the measured system clock in hertz.
+ * It returns at once with SWUART_AUTOBAUD_PENDING, or with SWUART_OK when the sync byte was measured,
+ * then Timer 0 calculates its periods at the measured clock (Timer0_setClock) and the driver is initialized
+ * by SWUART_init with the known baudrate, which empties the buffers.
+ */
+ En_SWUART_Error_t SWUART_calibrationDone(uint32_t *clock);
+ 
+/*
+ * baudrate: is an input argument that describes the known baudrate of the peer.
+ * It waits until the peer sends SWUART_SYNC_BYTE and returns the measured system clock, the driver is
+ * initialized with the baudrate at that clock.
+ * The OSCCAL register isn't changed, the tick is rescaled instead, which also corrects a crystal or resonator.
+ */
+ uint32_t SWUART_calibrate(uint32_t baudrate);
+ 
+#if SWUART_CLOCK_TRACKING
+/*
+ * enable: is an input argument that describes if the clock is tracked, 1, or not, 0.
+ * The clock tracking times the normal traffic of the channel with RX on the INT0 pin: INT0 timestamps the start
+ * edge of a frame and, when the bit before the stop bit is low, the rising edge into the stop bit, one more
+ * interrupt per frame. The frames received without errors are added up until SWUART_trackClock.
+ */
+ void SWUART_setClockTracking(uint8_t enable);
+ 
+/*
+ * clock: is an output argument that describes the system clock measured from the received frames in hertz.
+ * It returns at once with SWUART_NO_DATA until SWUART_CLOCK_TRACK_FRAMES frames were timed since the last update,
+ * then with SWUART_OK after Timer 0 is set to the measured clock and the tick follows it from its next match,
+ * so it can be called from the main loop to follow the drift of the clock without stopping the traffic.
+ * A measured clock out of SWUART_CLOCK_RANGE is dropped with SWUART_NO_DATA.
+ */
+ En_SWUART_Error_t SWUART_trackClock(uint32_t *clock);
+#endif
+ 
+/*
+ * The channel functions below work on the channel given by their channel argument, a channel that isn't open
+ * sends and receives nothing. The functions without a channel argument work on SWUART_DEFAULT_CHANNEL.
+ */
+
+/*
+ * channel: is an input argument that describes the channel number.
+ * data: is an input argument that describes a byte of data to be send.
+ * It waits only until there is a free place for the byte in the transmit buffer,
+ * it returns SWUART_OK or SWUART_WRONG_CHANNEL.
+ */
+ En_SWUART_Error_t SWUART_channelSend(uint8_t channel, SWUART_data_t data);
+ 
+/*
+ * channel: is an input argument that describes the channel number.
+ * data: is an input argument that describes a byte of data to be queued for transmission.
+ * It returns at once with SWUART_OK, SWUART_TX_BUFFER_FULL or SWUART_WRONG_CHANNEL.
+ */
+ En_SWUART_Error_t SWUART_channelSendAsync(uint8_t channel, SWUART_data_t data);
+ 
+/*
+ * channel: is an input argument that describes the channel number.
+ * data, length: are input arguments that describe the bytes to be queued for transmission.
+ * It returns at once with the number of bytes actually queued.
+ */
+ uint8_t SWUART_channelWrite(uint8_t channel, const SWUART_data_t *data, uint8_t length);
+ 
+/*
+ * channel: is an input argument that describes the channel number.
+ * It returns the number of bytes that can be queued now without blocking.
+ */
+ uint8_t SWUART_channelTxFree(uint8_t channel);
+ 
+/*
+ * channel: is an input argument that describes the channel number.
+ * It returns 1 if the transmit buffer is empty and the last frame has been shifted out, otherwise 0.
+ */
+ uint8_t SWUART_channelTxIdle(uint8_t channel);
+ 
+/*
+ * channel: is an input argument that describes the channel number.
+ * It returns the number of received bytes waiting in the receive buffer.
+ */
+ uint8_t SWUART_channelAvailable(uint8_t channel);
+ 
+/*
+ * channel: is an input argument that describes the channel number.
+ * It returns the number of start edges the receiver rejected, the glitches of its statistics.
+ */
+ uint16_t SWUART_channelRxGlitches(uint8_t channel);
+ 
+/*
+ * channel: is an input argument that describes the channel number.
+ * stats: is an output argument that describes the link statistics of the channel.
+ * It returns SWUART_OK or SWUART_WRONG_CHANNEL.
+ */
+ En_SWUART_Error_t SWUART_channelGetStats(uint8_t channel, ST_SWUART_stats_t *stats);
+ 
+/*
+ * channel: is an input argument that describes the channel number.
+ * It clears the link statistics of the channel.
+ */
+ void SWUART_channelResetStats(uint8_t channel);
+ 
+#if SWUART_FLOW_CONTROL
+/*
+ * channel: is an input argument that describes the channel number.
+ * flowControl: is an input argument that describes the SWUART_FLOW_ modes to be used, SWUART_FLOW_NONE turns it off.
+ * port, rtsPin, ctsPin: are input arguments that describe the RTS and CTS pins of SWUART_FLOW_RTS_CTS,
+ * they are ignored without it.
+ * It can be called any time after the channel is opened, opening the channel again turns the flow control off.
+ * It returns SWUART_OK, SWUART_WRONG_CHANNEL or SWUART_WRONG_PIN.
+ */
+ En_SWUART_Error_t SWUART_channelSetFlowControl(uint8_t channel, uint8_t flowControl, uint8_t port, uint8_t rtsPin, uint8_t ctsPin);
+#endif
+ 
+#if SWUART_LINE_MODE
+/*
+ * channel: is an input argument that describes the channel number.
+ * buffer0, buffer1: are input arguments that describe the two line buffers, of size bytes each,
+ * they belong to the driver until the line mode is turned off.
+ * size: is an input argument that describes the longest line, 0 turns the line mode off.
+ * delimiter: is an input argument that describes the byte that ends a line, it isn't put in the line.
+ * In the line mode the ISR puts the received bytes straight in one line buffer instead of the receive buffer.
+ * At the delimiter, or when the buffer is full, the line is handed to the application, which reads it in place
+ * with SWUART_channelTryReceiveLine while the next line fills the other buffer, and gives it back with
+ * SWUART_channelReleaseLine. If the next line ends first it waits in its buffer, and the bytes after it
+ * are dropped until the release. The flow control doesn't act on the lines.
+ * It can be called any time after the channel is opened, the line being received is dropped,
+ * opening the channel again turns the line mode off.
+ * It returns SWUART_OK or SWUART_WRONG_CHANNEL.
+ */
+ En_SWUART_Error_t SWUART_channelSetLineMode(uint8_t channel, SWUART_data_t *buffer0, SWUART_data_t *buffer1, uint8_t size, SWUART_data_t delimiter);
+ 
+/*
+ * channel: is an input argument that describes the channel number.
+ * line: is an output argument that describes the received line, in one of the line buffers, left unchanged if there is none.
+ * length: is an output argument that describes the number of bytes in the line, without the delimiter.
+ * status: is an output argument that describes the SWUART_STATUS_ flags of the line.
+ * The line stays in its buffer, and is returned again, until SWUART_channelReleaseLine.
+ * It returns at once with SWUART_OK, SWUART_NO_DATA or SWUART_WRONG_CHANNEL.
+ */
+ En_SWUART_Error_t SWUART_channelTryReceiveLine(uint8_t channel, SWUART_data_t **line, uint8_t *length, uint8_t *status);
+ 
+/*
+ * channel: is an input argument that describes the channel number.
+ * line, length, status: are output arguments like in SWUART_channelTryReceiveLine.
+ * It waits until a line is received, it returns SWUART_OK, or SWUART_WRONG_CHANNEL or SWUART_NO_DATA
+ * at once if the channel isn't open or isn't in the line mode.
+ */
+ En_SWUART_Error_t SWUART_channelReceiveLine(uint8_t channel, SWUART_data_t **line, uint8_t *length, uint8_t *status);
+ 
+/*
+ * channel: is an input argument that describes the channel number.
+ * It gives the buffer of the received line back to the driver, the line waiting behind it is handed over at once.
+ * It returns SWUART_OK, SWUART_NO_DATA if no line was received or SWUART_WRONG_CHANNEL.
+ */
+ En_SWUART_Error_t SWUART_channelReleaseLine(uint8_t channel);
+#endif
+ 
+#if SWUART_DATA_BITS == 9
+/*
+ * channel: is an input argument that describes the channel number.
+ * enable: is an input argument that describes if the multidrop addressing is used, 1, or not, 0.
+ * address: is an input argument that describes the address of this node.
+ * In the multidrop addressing the ISR drops the received frames until an address frame with the node address,
+ * then it receives that address frame, with SWUART_ADDRESS_MARK set so the application sees the start of the message,
+ * and the data frames after it until the next address frame, with another address or with errors.
+ * The frames for the other nodes cost only the ISR, they aren't put in the buffers and wake no receive function.
+ * The node isn't addressed when it is turned on, opening the channel again turns it off.
+ * It returns SWUART_OK or SWUART_WRONG_CHANNEL.
+ */
+ En_SWUART_Error_t SWUART_channelSetMultidrop(uint8_t channel, uint8_t enable, uint8_t address);
+ 
+/*
+ * channel: is an input argument that describes the channel number.
+ * address: is an input argument that describes the node the next data frames are for.
+ * It sends an address frame like SWUART_channelSend, it returns SWUART_OK or SWUART_WRONG_CHANNEL.
+ */
+ En_SWUART_Error_t SWUART_channelSendAddress(uint8_t channel, uint8_t address);
+#endif
+ 
+/*
+ * channel: is an input argument that describes the channel number.
+ * It returns the oldest byte in the receive buffer and removes it, or 0 if the buffer is empty.
+ */
+ SWUART_data_t SWUART_channelRead(uint8_t channel);
+ 
+/*
+ * channel: is an input argument that describes the channel number.
+ * data: is an output argument that describes the received byte.
+ * It waits until a byte is in the receive buffer, it returns SWUART_OK or SWUART_WRONG_CHANNEL.
+ */
+ En_SWUART_Error_t SWUART_channelReceive(uint8_t channel, SWUART_data_t *data);
+ 
+/*
+ * channel: is an input argument that describes the channel number.
+ * data: is an output argument that describes the received byte, left unchanged if there is none.
+ * It returns at once with SWUART_OK, SWUART_NO_DATA or SWUART_WRONG_CHANNEL.
+ */
+ En_SWUART_Error_t SWUART_channelTryReceive(uint8_t channel, SWUART_data_t *data);
+ 
+/*
+ * channel: is an input argument that describes the channel number.
+ * data: is an output argument that describes the received byte, left unchanged if there is none.
+ * status: is an output argument that describes the SWUART_STATUS_ flags of the received byte.
+ * It returns at once with SWUART_OK, SWUART_NO_DATA or SWUART_WRONG_CHANNEL.
+ */
+ En_SWUART_Error_t SWUART_channelTryReceiveStatus(uint8_t channel, SWUART_data_t *data, uint8_t *status);
+ 
+/*
+ * channel: is an input argument that describes the channel number.
+ * data: is an output argument that describes the received byte.
+ * ticks: is an input argument that describes the longest time to wait in Timer 0 ticks,
+ * there are SWUART_TICKS_PER_BIT ticks in a bit time of the first channel opened.
+ * It returns SWUART_OK, SWUART_TIMEOUT or SWUART_WRONG_CHANNEL.
+ */
+ En_SWUART_Error_t SWUART_channelReceiveTimeout(uint8_t channel, SWUART_data_t *data, uint32_t ticks);
+ 
+/*
+ * channel: is an input argument that describes the channel number.
+ * data, length: are input arguments that describe the bytes to be sent.
+ * It queues all the bytes, waiting whenever the transmit buffer is full, and returns when the last one is queued.
+ * The frames go on the line back to back with SWUART_STOP_BITS stop bits between them.
+ * It returns SWUART_OK, or SWUART_WRONG_CHANNEL if the channel isn't open or is closed before the last byte is queued.
+ */
+ En_SWUART_Error_t SWUART_channelSendBuffer(uint8_t channel, const SWUART_data_t *data, uint16_t length);
+ 
+/*
+ * channel: is an input argument that describes the channel number.
+ * data: is an output argument that describes the received bytes.
+ * length: is an input argument that describes the number of bytes to be received.
+ * timeout: is an input argument that describes the longest time to wait for all of them in milliseconds,
+ * SWUART_NO_TIMEOUT waits until all of them are received.
+ * It returns the number of bytes received, less than length if the time ran out or the channel isn't open or is closed.
+ * In the line mode the bytes go to the line buffers, so it returns 0 at once, the lines are read by SWUART_channelReceiveLine.
+ */
+ uint16_t SWUART_channelReceiveBuffer(uint8_t channel, SWUART_data_t *data, uint16_t length, uint16_t timeout);
+ 
+/*
+ * data: is an input argument that describes a byte of data to be send over the SW UART.
+ * It waits only until there is a free place for the byte in the transmit buffer.
+ */
+ void SWUART_send(SWUART_data_t data);
+ 
+/*
+ * data: is an input argument that describes a byte of data to be queued for transmission.
+ * It returns at once with SWUART_OK, or SWUART_TX_BUFFER_FULL if the byte couldn't be queued.
+ */
+ En_SWUART_Error_t SWUART_sendAsync(SWUART_data_t data);
+ 
+/*
+ * data: is an input argument that describes the bytes to be queued for transmission.
+ * length: is an input argument that describes the number of bytes in data.
+ * It returns at once with the number of bytes actually queued, which is less than length if the buffer got full.
+ */
+ uint8_t SWUART_write(const SWUART_data_t *data, uint8_t length);
+ 
+/*
+ * It returns the number of bytes that can be queued now without blocking.
+ */
+ uint8_t SWUART_txFree(void);
+ 
+/*
+ * It returns 1 if the transmit buffer is empty and the last frame has been shifted out, otherwise 0.
+ */
+ uint8_t SWUART_txIdle(void);
+ 
+/*
+ * It returns the number of received bytes waiting in the receive buffer.
+ */
+ uint8_t SWUART_available(void);
+ 
+/*
+ * It returns the number of glitches the receiver rejected since SWUART_init or SWUART_resetStats,
+ * start edges that were high again in the middle of the start bit.
+ * It is always 0 in the SWUART_RX_SINGLE_SAMPLE mode.
+ */
+ uint16_t SWUART_rxGlitches(void);
+ 
+/*
+ * stats: is an output argument that describes the link statistics of the default channel.
+ */
+ void SWUART_getStats(ST_SWUART_stats_t *stats);
+ 
+/*
+ * It clears the link statistics of the default channel.
+ */
+ void SWUART_resetStats(void);
+ 
+#if SWUART_FLOW_CONTROL
+/*
+ * flowControl: is an input argument that describes the SWUART_FLOW_ modes of the default channel.
+ * port, rtsPin, ctsPin: are input arguments that describe the RTS and CTS pins of SWUART_FLOW_RTS_CTS.
+ * It returns SWUART_OK or SWUART_WRONG_PIN.
+ */
+ En_SWUART_Error_t SWUART_setFlowControl(uint8_t flowControl, uint8_t port, uint8_t rtsPin, uint8_t ctsPin);
+#endif
+ 
+#if SWUART_LINE_MODE
+/*
+ * buffer0, buffer1, size, delimiter: are input arguments like in SWUART_channelSetLineMode.
+ * It turns the line mode of the default channel on, or off with size 0.
+ * It returns SWUART_OK, or SWUART_WRONG_CHANNEL if the default channel isn't open.
+ */
+ En_SWUART_Error_t SWUART_setLineMode(SWUART_data_t *buffer0, SWUART_data_t *buffer1, uint8_t size, SWUART_data_t delimiter);
+ 
+/*
+ * line, length, status: are output arguments like in SWUART_channelTryReceiveLine.
+ * It returns at once with SWUART_OK, or SWUART_NO_DATA if no line was received.
+ */
+ En_SWUART_Error_t SWUART_tryReceiveLine(SWUART_data_t **line, uint8_t *length, uint8_t *status);
+ 
+/*
+ * line, length, status: are output arguments like in SWUART_channelTryReceiveLine.
+ * It waits until a line is received.
+ */
+ void SWUART_receiveLine(SWUART_data_t **line, uint8_t *length, uint8_t *status);
+ 
+/*
+ * It gives the buffer of the received line back to the driver.
+ */
+ void SWUART_releaseLine(void);
+#endif
+ 
+#if SWUART_DATA_BITS == 9
+/*
+ * enable, address: are input arguments like in SWUART_channelSetMultidrop.
+ * It turns the multidrop addressing of the default channel on, or off with enable 0.
+ * It returns SWUART_OK, or SWUART_WRONG_CHANNEL if the default channel isn't open.
+ */
+ En_SWUART_Error_t SWUART_setMultidrop(uint8_t enable, uint8_t address);
+ 
+/*
+ * address: is an input argument that describes the node the next data frames are for.
+ * It sends an address frame on the default channel, waiting only for a free place in the transmit buffer.
+ */
+ void SWUART_sendAddress(uint8_t address);
+#endif
+ 
+/*
+ * It returns the oldest byte in the receive buffer and removes it.
+ * It must be called only when SWUART_available() is not 0, otherwise it returns 0.
+ */
+ SWUART_data_t SWUART_read(void);
+ 
+ /*
+ * data: is an output argument that describes a byte of data to be recieved by the SW UART.
+ * It waits until a byte is in the receive buffer.
+ */
+ void SWUART_recieve(SWUART_data_t *data);
+ 
+/*
+ * data: is an output argument that describes the received byte, left unchanged if there is none.
+ * It returns at once with SWUART_OK, or SWUART_NO_DATA if the receive buffer is empty.
+ */
+ En_SWUART_Error_t SWUART_tryReceive(SWUART_data_t *data);
+ 
+/*
+ * data: is an output argument that describes the received byte, left unchanged if there is none.
+ * status: is an output argument that describes the SWUART_STATUS_ flags of the received byte.
+ * It returns at once with SWUART_OK, or SWUART_NO_DATA if the receive buffer is empty.
+ */
+ En_SWUART_Error_t SWUART_tryReceiveStatus(SWUART_data_t *data, uint8_t *status);
+ 
+/*
+ * data: is an output argument that describes the received byte.
+ * ticks: is an input argument that describes the longest time to wait in Timer 0 ticks,
+ * SWUART_TICKS_PER_BIT for every bit time.
+ * It returns SWUART_OK, or SWUART_TIMEOUT if nothing was received in time.
+ */
+ En_SWUART_Error_t SWUART_receiveTimeout(SWUART_data_t *data, uint32_t ticks);
+ 
+/*
+ * data, length: are input arguments that describe the bytes to be sent, streamed back to back.
+ * It waits until the last byte is queued.
+ */
+ void SWUART_sendBuffer(const SWUART_data_t *data, uint16_t length);
+ 
+/*
+ * data: is an output argument that describes the received bytes.
+ * length: is an input argument that describes the number of bytes to be received.
+ * timeout: is an input argument that describes the longest time to wait in milliseconds, or SWUART_NO_TIMEOUT.
+ * It returns the number of bytes received.
+ */
+ uint16_t SWUART_receiveBuffer(SWUART_data_t *data, uint16_t length, uint16_t timeout);
+ 
+ #endif //SWUART_H_
+ 
+ 
+ //////////////////////////////////////////////////////////
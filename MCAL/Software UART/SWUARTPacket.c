@@ -0,0 +1,261 @@
+//############# SWUARTPacket.c ##############
+#include "SWUARTPacket.h"
+#include "../../Service/ProgramMemory.h"
+
+//longest run of nonzero bytes in a COBS block, its code is 0xFF and no 0 follows it
+#define SWUART_COBS_MAX_RUN 254
+
+//CRC-16/CCITT-FALSE of every value of the high byte of the CRC xor the next byte
+static const uint16_t SWUART_globalCrc16Table[256] FLASH =
+{
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+	0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+	0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+	0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+	0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+	0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+	0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+	0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+	0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+	0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+	0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+	0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+	0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+	0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+	0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+	0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+	0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+	0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+	0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+	0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+	0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+	0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+	0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+	0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+	0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+	0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+	0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+	0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+	0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+	0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+	0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+
+uint16_t SWUART_crc16(uint16_t crc, const uint8_t *data, uint16_t length)
+{
+	while(length != 0)
+	{
+		crc = (crc << 8) ^ readFlashWord(&SWUART_globalCrc16Table[(uint8_t)(crc >> 8) ^ *data]);
+		data++;
+		length--;
+	}
+	return crc;
+}
+
+
+//byte of the packet on the line before the COBS encoding: the data, then the CRC high byte first
+static uint8_t SWUART_packetByte(const uint8_t *data, uint16_t length, uint16_t crc, uint16_t index)
+{
+	uint8_t byte;
+	if(index < length)
+	{
+		byte = data[index];
+	}
+	else if(index == length)
+	{
+		byte = (uint8_t)(crc >> 8);
+	}
+	else
+	{
+		byte = (uint8_t)crc;
+	}
+	return byte;
+}
+
+
+En_SWUART_Packet_Error_t SWUART_channelSendPacket(uint8_t channel, const uint8_t *data, uint16_t length)
+{
+	En_SWUART_Packet_Error_t SWUART_packetError = SWUART_PACKET_OK;
+	uint16_t crc = SWUART_crc16(SWUART_CRC16_INIT, data, length);
+	uint16_t total = length + 2;
+	uint16_t blockStart = 0;
+	uint8_t sending = 1;
+	//the bytes are encoded while they are queued, every block looks ahead for its next 0 in the data itself
+	while(sending)
+	{
+		uint16_t blockEnd = blockStart;
+		while(blockEnd < total && blockEnd - blockStart < SWUART_COBS_MAX_RUN
+			&& SWUART_packetByte(data, length, crc, blockEnd) != 0)
+		{
+			blockEnd++;
+		}
+		uint8_t code = blockEnd - blockStart + 1;
+		//the channel may be closed at any byte, then the rest of the packet is dropped
+		En_SWUART_Error_t SWUART_error = SWUART_channelSend(channel, code);
+		for(uint16_t i = blockStart; i < blockEnd && SWUART_error == SWUART_OK; i++)
+		{
+			SWUART_error = SWUART_channelSend(channel, SWUART_packetByte(data, length, crc, i));
+		}
+		//a full block has no 0 after it, any other block stands for the 0 at blockEnd, or for the end of the packet
+		if(code == SWUART_COBS_MAX_RUN + 1)
+		{
+			blockStart = blockEnd;
+			sending = blockEnd < total;
+		}
+		else
+		{
+			blockStart = blockEnd + 1;
+			sending = blockStart <= total;
+		}
+		if(SWUART_error != SWUART_OK)
+		{
+			SWUART_packetError = SWUART_PACKET_WRONG_CHANNEL;
+			sending = 0;
+		}
+	}
+	if(SWUART_packetError == SWUART_PACKET_OK && SWUART_channelSend(channel, 0) != SWUART_OK)
+	{
+		SWUART_packetError = SWUART_PACKET_WRONG_CHANNEL;
+	}
+	return SWUART_packetError;
+}
+
+
+void SWUART_packetDecoderInit(ST_SWUART_packetDecoder_t *decoder, uint8_t *buffer, uint16_t size)
+{
+	decoder->buffer = buffer;
+	decoder->size = size;
+	decoder->length = 0;
+	decoder->crc = SWUART_CRC16_INIT;
+	decoder->numOfBytes = 0;
+	decoder->blockLeft = 0;
+	decoder->zeroPending = 0;
+	decoder->error = SWUART_PACKET_PENDING;
+}
+
+
+//adds a decoded byte, the byte 2 places before it can't be the CRC any more and goes to the buffer
+static void SWUART_packetDecoderAdd(ST_SWUART_packetDecoder_t *decoder, uint8_t byte)
+{
+	decoder->crc = (decoder->crc << 8) ^ readFlashWord(&SWUART_globalCrc16Table[(uint8_t)(decoder->crc >> 8) ^ byte]);
+	if(decoder->numOfBytes < 2)
+	{
+		decoder->crcBytes[decoder->numOfBytes++] = byte;
+	}
+	else
+	{
+		if(decoder->length < decoder->size)
+		{
+			decoder->buffer[decoder->length++] = decoder->crcBytes[0];
+		}
+		else
+		{
+			decoder->error = SWUART_PACKET_TOO_LONG;
+		}
+		decoder->crcBytes[0] = decoder->crcBytes[1];
+		decoder->crcBytes[1] = byte;
+	}
+}
+
+
+En_SWUART_Packet_Error_t SWUART_packetDecode(ST_SWUART_packetDecoder_t *decoder, uint8_t data, uint8_t status)
+{
+	En_SWUART_Packet_Error_t SWUART_packetError = SWUART_PACKET_PENDING;
+	if(data == 0)
+	{
+		//the delimiter ends the packet whatever happened in it, so the next byte is in sync again
+		uint8_t empty = decoder->numOfBytes == 0 && decoder->blockLeft == 0 && !decoder->zeroPending;
+		if(!empty || decoder->error != SWUART_PACKET_PENDING)
+		{
+			if(decoder->error != SWUART_PACKET_PENDING)
+			{
+				SWUART_packetError = decoder->error;
+			}
+			else if(decoder->blockLeft != 0)
+			{
+				SWUART_packetError = SWUART_PACKET_FRAMING_ERROR;
+			}
+			else if(decoder->numOfBytes < 2 || decoder->crc != 0)
+			{
+				SWUART_packetError = SWUART_PACKET_CRC_ERROR;
+			}
+			else
+			{
+				SWUART_packetError = SWUART_PACKET_OK;
+			}
+		}
+		uint16_t length = decoder->length;
+		SWUART_packetDecoderInit(decoder, decoder->buffer, decoder->size);
+		if(SWUART_packetError == SWUART_PACKET_OK)
+		{
+			decoder->length = length;
+		}
+	}
+	else if(decoder->error == SWUART_PACKET_PENDING)
+	{
+		//a new packet starts with its data written over the last one
+		if(decoder->numOfBytes == 0 && decoder->blockLeft == 0 && !decoder->zeroPending)
+		{
+			decoder->length = 0;
+		}
+		if(status & (SWUART_STATUS_PARITY_ERROR | SWUART_STATUS_FRAMING_ERROR | SWUART_STATUS_OVERRUN))
+		{
+			decoder->error = SWUART_PACKET_FRAMING_ERROR;
+		}
+		else if(decoder->blockLeft != 0)
+		{
+			SWUART_packetDecoderAdd(decoder, data);
+			decoder->blockLeft--;
+		}
+		else
+		{
+			//a block code, the 0 the last block stands for is added only now as the packet goes on
+			if(decoder->zeroPending)
+			{
+				SWUART_packetDecoderAdd(decoder, 0);
+			}
+			decoder->blockLeft = data - 1;
+			decoder->zeroPending = data != SWUART_COBS_MAX_RUN + 1;
+		}
+	}
+	return SWUART_packetError;
+}
+
+
+En_SWUART_Packet_Error_t SWUART_channelPollPacket(uint8_t channel, ST_SWUART_packetDecoder_t *decoder)
+{
+	En_SWUART_Packet_Error_t SWUART_packetError = SWUART_PACKET_PENDING;
+	SWUART_data_t data;
+	uint8_t status;
+	En_SWUART_Error_t SWUART_error = SWUART_channelTryReceiveStatus(channel, &data, &status);
+	while(SWUART_error == SWUART_OK && SWUART_packetError == SWUART_PACKET_PENDING)
+	{
+		SWUART_packetError = SWUART_packetDecode(decoder, (uint8_t)data, status);
+		if(SWUART_packetError == SWUART_PACKET_PENDING)
+		{
+			SWUART_error = SWUART_channelTryReceiveStatus(channel, &data, &status);
+		}
+	}
+	if(SWUART_error == SWUART_WRONG_CHANNEL)
+	{
+		SWUART_packetError = SWUART_PACKET_WRONG_CHANNEL;
+	}
+	return SWUART_packetError;
+}
+
+
+void SWUART_sendPacket(const uint8_t *data, uint16_t length)
+{
+	SWUART_channelSendPacket(SWUART_DEFAULT_CHANNEL, data, length);
+}
+
+
+En_SWUART_Packet_Error_t SWUART_pollPacket(ST_SWUART_packetDecoder_t *decoder)
+{
+	return SWUART_channelPollPacket(SWUART_DEFAULT_CHANNEL, decoder);
+}
+
+
+//////////////////////////////////////////////////////////
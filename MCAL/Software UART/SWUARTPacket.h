@@ -0,0 +1,113 @@
+//############# SWUARTPacket.h ##############
+
+#ifndef SWUARTPACKET_H_
+#define SWUARTPACKET_H_
+
+#include "SWUART.h"
+
+/*
+ * Packet layer on top of the SW UART channels.
+ * A packet is its data followed by a CRC-16 of the data, high byte first, COBS encoded so no byte of it is 0,
+ * and a 0 delimiter after it. A receiver that lost its place in the stream, after a bit slip or a dropped byte,
+ * drops the packet in flight and starts again at the next delimiter.
+ * The CRC is CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF), from a 512 byte table in the flash.
+ * The COBS encoding adds one byte per 254 bytes of the packet, so a packet of n data bytes takes
+ * n + 3 + n/254 frames on the line.
+ */
+#if SWUART_DATA_BITS < 8
+#error "the packets are made of bytes, build them with 8 or more data bits"
+#endif
+
+//initial value of SWUART_crc16 for a new CRC
+#define SWUART_CRC16_INIT 0xFFFF
+
+/*
+ * Status values returned by the packet functions.
+ */
+typedef enum
+{
+	SWUART_PACKET_OK,				/* a packet was sent, or a whole packet was received with a good CRC */
+	SWUART_PACKET_PENDING,			/* the delimiter of the packet in flight hasn't been received yet */
+	SWUART_PACKET_CRC_ERROR,		/* the CRC of the received packet is wrong, or it is shorter than the CRC */
+	SWUART_PACKET_FRAMING_ERROR,	/* a COBS block was cut by the delimiter, or a byte was received with an error status */
+	SWUART_PACKET_TOO_LONG,			/* the received packet didn't fit in the buffer of the decoder */
+	SWUART_PACKET_WRONG_CHANNEL		/* the channel number is out of range or the channel isn't open */
+}En_SWUART_Packet_Error_t;
+
+/*
+ * State of a receiving decoder, fed one received byte at a time by SWUART_packetDecode.
+ * It uses only the buffer given to SWUART_packetDecoderInit, the last 2 bytes decoded are held back
+ * in crcBytes as they may be the CRC.
+ */
+typedef struct
+{
+	uint8_t *buffer;		/* data of the packet in flight */
+	uint16_t size;			/* size of the buffer */
+	uint16_t length;		/* data bytes of the packet in flight, the length of the packet after SWUART_PACKET_OK */
+	uint16_t crc;			/* CRC of the bytes decoded so far, 0 at the end of a good packet */
+	uint8_t crcBytes[2];	/* the last 2 bytes decoded */
+	uint8_t numOfBytes;		/* bytes in crcBytes, 0 to 2 */
+	uint8_t blockLeft;		/* data bytes left in the COBS block, 0 when the next byte is a block code */
+	uint8_t zeroPending;	/* the COBS block ends with a 0 that is added when the next block starts */
+	uint8_t error;			/* En_SWUART_Packet_Error_t of the packet in flight, SWUART_PACKET_PENDING while it is good */
+}ST_SWUART_packetDecoder_t;
+
+/*
+ * crc: is an input argument that describes the CRC of the bytes before data, or SWUART_CRC16_INIT.
+ * data, length: are input arguments that describe the bytes to be added to the CRC.
+ * It returns the CRC-16/CCITT-FALSE of the bytes, a CRC over bytes followed by their CRC high byte first is 0.
+ */
+ uint16_t SWUART_crc16(uint16_t crc, const uint8_t *data, uint16_t length);
+
+/*
+ * channel: is an input argument that describes the channel number.
+ * data, length: are input arguments that describe the data of the packet.
+ * It sends the packet like SWUART_channelSendBuffer, waiting whenever the transmit buffer is full,
+ * and returns when its delimiter is queued, with SWUART_PACKET_OK or SWUART_PACKET_WRONG_CHANNEL.
+ * A channel closed before the delimiter is queued stops the packet there with SWUART_PACKET_WRONG_CHANNEL.
+ */
+ En_SWUART_Packet_Error_t SWUART_channelSendPacket(uint8_t channel, const uint8_t *data, uint16_t length);
+
+/*
+ * decoder: is an output argument that describes the decoder to be initialized.
+ * buffer, size: are input arguments that describe where the data of the received packets is kept.
+ * A packet with more than size data bytes is dropped with SWUART_PACKET_TOO_LONG.
+ */
+ void SWUART_packetDecoderInit(ST_SWUART_packetDecoder_t *decoder, uint8_t *buffer, uint16_t size);
+
+/*
+ * decoder: is an input/output argument that describes the decoder.
+ * data: is an input argument that describes the next received byte.
+ * status: is an input argument that describes the SWUART_STATUS_ flags of the byte, a parity, framing or overrun
+ * flag drops the packet in flight.
+ * It returns SWUART_PACKET_PENDING until the delimiter, then the result of the packet: SWUART_PACKET_OK with its
+ * data in the buffer and its length in decoder->length, or the first error seen in it.
+ * The next byte starts a new packet, and the delimiters without a packet between them are skipped.
+ */
+ En_SWUART_Packet_Error_t SWUART_packetDecode(ST_SWUART_packetDecoder_t *decoder, uint8_t data, uint8_t status);
+
+/*
+ * channel: is an input argument that describes the channel number.
+ * decoder: is an input/output argument that describes the decoder of the channel.
+ * It feeds the received bytes of the channel to the decoder until a packet ends or the receive buffer is empty,
+ * and returns at once with the result of SWUART_packetDecode, SWUART_PACKET_PENDING if no packet ended,
+ * or SWUART_PACKET_WRONG_CHANNEL.
+ */
+ En_SWUART_Packet_Error_t SWUART_channelPollPacket(uint8_t channel, ST_SWUART_packetDecoder_t *decoder);
+
+/*
+ * data, length: are input arguments that describe the data of the packet.
+ * It sends the packet on the default channel and returns when its delimiter is queued.
+ */
+ void SWUART_sendPacket(const uint8_t *data, uint16_t length);
+
+/*
+ * decoder: is an input/output argument that describes the decoder of the default channel.
+ * It returns at once with the result of SWUART_channelPollPacket on the default channel.
+ */
+ En_SWUART_Packet_Error_t SWUART_pollPacket(ST_SWUART_packetDecoder_t *decoder);
+
+ #endif //SWUARTPACKET_H_
+
+
+ //////////////////////////////////////////////////////////
@@ -0,0 +1,298 @@
+//############# SWUARTPrint.c ##############
+#include <stdarg.h>
+#include "SWUARTPrint.h"
+#include "../../Service/ProgramMemory.h"
+
+//digits of the largest uint32_t
+#define SWUART_PRINT_MAX_DIGITS		10
+//digits of the powers of ten done in 32 bit, the value is below 10000 after them
+#define SWUART_PRINT_LONG_DIGITS	6
+
+//10^9 down to 10^4, taken away from the value in 32 bit
+static const uint32_t SWUART_globalLongPowers[SWUART_PRINT_LONG_DIGITS] FLASH =
+{
+	1000000000, 100000000, 10000000, 1000000, 100000, 10000
+};
+
+//10^3 down to 10, taken away from the value in 16 bit
+static const uint16_t SWUART_globalShortPowers[SWUART_PRINT_MAX_DIGITS - SWUART_PRINT_LONG_DIGITS - 1] FLASH =
+{
+	1000, 100, 10
+};
+
+static const char SWUART_globalHexDigits[] = "0123456789ABCDEF";
+
+#ifdef HOST_SIM
+uint32_t SWUART_printLongSteps = 0;
+uint32_t SWUART_printShortSteps = 0;
+//counts a compare of the value with a power of ten, and its subtraction if it is taken away
+#define SWUART_PRINT_STEP(steps)	((steps)++)
+#else
+#define SWUART_PRINT_STEP(steps)	((void)0)
+#endif
+
+
+//sends count copies of pad, and returns the error of the last one
+static En_SWUART_Error_t SWUART_printPad(uint8_t channel, char pad, uint8_t count)
+{
+	En_SWUART_Error_t SWUART_error = SWUART_OK;
+	for(; count > 0; count--)
+	{
+		SWUART_error = SWUART_channelSend(channel, pad);
+	}
+	return SWUART_error;
+}
+
+
+//sends value in decimal right aligned in width, with a '-' before it if negative,
+//the spaces of the padding go before the '-' and the zeros after it
+static En_SWUART_Error_t SWUART_printDecimal(uint8_t channel, uint32_t value, uint8_t negative, uint8_t width, char pad)
+{
+	En_SWUART_Error_t SWUART_error;
+	uint8_t first = 0;
+	//the first digit is the one of the largest power of ten not above the value
+	while(first < SWUART_PRINT_LONG_DIGITS
+		&& (SWUART_PRINT_STEP(SWUART_printLongSteps), value < readFlashDword(&SWUART_globalLongPowers[first])))
+	{
+		first++;
+	}
+	if(first == SWUART_PRINT_LONG_DIGITS)
+	{
+		while(first < SWUART_PRINT_MAX_DIGITS - 1 && (SWUART_PRINT_STEP(SWUART_printShortSteps),
+			(uint16_t)value < readFlashWord(&SWUART_globalShortPowers[first - SWUART_PRINT_LONG_DIGITS])))
+		{
+			first++;
+		}
+	}
+	uint8_t numOfChars = SWUART_PRINT_MAX_DIGITS - first + (negative != 0);
+	if(pad != '0')
+	{
+		SWUART_printPad(channel, pad, width > numOfChars ? width - numOfChars : 0);
+	}
+	if(negative)
+	{
+		SWUART_channelSend(channel, '-');
+	}
+	if(pad == '0')
+	{
+		SWUART_printPad(channel, pad, width > numOfChars ? width - numOfChars : 0);
+	}
+	//every digit is the number of times its power of ten can be taken away, at most 9
+	for(; first < SWUART_PRINT_LONG_DIGITS; first++)
+	{
+		uint32_t power = readFlashDword(&SWUART_globalLongPowers[first]);
+		char digit = '0';
+		while(SWUART_PRINT_STEP(SWUART_printLongSteps), value >= power)
+		{
+			value -= power;
+			digit++;
+		}
+		SWUART_channelSend(channel, digit);
+	}
+	uint16_t shortValue = value;
+	for(; first < SWUART_PRINT_MAX_DIGITS - 1; first++)
+	{
+		uint16_t power = readFlashWord(&SWUART_globalShortPowers[first - SWUART_PRINT_LONG_DIGITS]);
+		char digit = '0';
+		while(SWUART_PRINT_STEP(SWUART_printShortSteps), shortValue >= power)
+		{
+			shortValue -= power;
+			digit++;
+		}
+		SWUART_channelSend(channel, digit);
+	}
+	SWUART_error = SWUART_channelSend(channel, '0' + shortValue);
+	return SWUART_error;
+}
+
+
+//sends value in hexadecimal right aligned in width, lowerCase is 0x20 for the lower case letters or 0
+static En_SWUART_Error_t SWUART_printHexDigits(uint8_t channel, uint32_t value, uint8_t width, char pad, uint8_t lowerCase)
+{
+	En_SWUART_Error_t SWUART_error;
+	uint8_t numOfDigits = 1;
+	while(numOfDigits < 8 && (value >> (4*numOfDigits)) != 0)
+	{
+		numOfDigits++;
+	}
+	SWUART_printPad(channel, pad, width > numOfDigits ? width - numOfDigits : 0);
+	do
+	{
+		numOfDigits--;
+		//lowerCase doesn't change the digits 0 to 9, 0x20 is already set in them
+		SWUART_error = SWUART_channelSend(channel, SWUART_globalHexDigits[(value >> (4*numOfDigits)) & 0x0F] | lowerCase);
+	}while(numOfDigits > 0);
+	return SWUART_error;
+}
+
+
+En_SWUART_Error_t SWUART_channelPrintString(uint8_t channel, const char *string)
+{
+	En_SWUART_Error_t SWUART_error = SWUART_OK;
+	for(; *string != '\0'; string++)
+	{
+		SWUART_error = SWUART_channelSend(channel, (uint8_t)*string);
+	}
+	return SWUART_error;
+}
+
+
+En_SWUART_Error_t SWUART_channelPrintU32(uint8_t channel, uint32_t value)
+{
+	return SWUART_printDecimal(channel, value, 0, 0, ' ');
+}
+
+
+En_SWUART_Error_t SWUART_channelPrintS32(uint8_t channel, sint32_t value)
+{
+	//the magnitude is taken in unsigned, -2^31 doesn't fit in a sint32_t
+	return SWUART_printDecimal(channel, value < 0 ? 0 - (uint32_t)value : (uint32_t)value, value < 0, 0, ' ');
+}
+
+
+En_SWUART_Error_t SWUART_channelPrintS16(uint8_t channel, sint16_t value)
+{
+	return SWUART_channelPrintS32(channel, value);
+}
+
+
+En_SWUART_Error_t SWUART_channelPrintHex(uint8_t channel, uint32_t value, uint8_t digits)
+{
+	return SWUART_printHexDigits(channel, value, digits, '0', 0);
+}
+
+
+static En_SWUART_Error_t SWUART_channelVprintf(uint8_t channel, const char *format, va_list args)
+{
+	En_SWUART_Error_t SWUART_error = SWUART_OK;
+	for(; *format != '\0'; format++)
+	{
+		if(*format != '%')
+		{
+			SWUART_error = SWUART_channelSend(channel, (uint8_t)*format);
+			continue;
+		}
+		const char *conversion = format;
+		char pad = ' ';
+		uint8_t width = 0;
+		uint8_t isLong = 0;
+		format++;
+		if(*format == '0')
+		{
+			pad = '0';
+			format++;
+		}
+		while(*format >= '0' && *format <= '9')
+		{
+			width = 10*width + (*format - '0');
+			format++;
+		}
+		if(*format == 'l')
+		{
+			isLong = 1;
+			format++;
+		}
+		switch(*format)
+		{
+			case 'c':
+				SWUART_printPad(channel, ' ', width > 1 ? width - 1 : 0);
+				SWUART_error = SWUART_channelSend(channel, (uint8_t)va_arg(args, int));
+				break;
+			case 's':
+			{
+				const char *string = va_arg(args, const char *);
+				uint8_t length = 0;
+				while(length < width && string[length] != '\0')
+				{
+					length++;
+				}
+				SWUART_printPad(channel, ' ', width - length);
+				SWUART_error = SWUART_channelPrintString(channel, string);
+				break;
+			}
+			case 'd':
+			case 'i':
+			{
+				sint32_t value = isLong ? va_arg(args, long) : va_arg(args, int);
+				SWUART_error = SWUART_printDecimal(channel, value < 0 ? 0 - (uint32_t)value : (uint32_t)value,
+					value < 0, width, pad);
+				break;
+			}
+			case 'u':
+				SWUART_error = SWUART_printDecimal(channel,
+					isLong ? va_arg(args, unsigned long) : va_arg(args, unsigned int), 0, width, pad);
+				break;
+			case 'x':
+			case 'X':
+				SWUART_error = SWUART_printHexDigits(channel,
+					isLong ? va_arg(args, unsigned long) : va_arg(args, unsigned int), width, pad, *format & 0x20);
+				break;
+			case '%':
+				SWUART_error = SWUART_channelSend(channel, '%');
+				break;
+			default:
+				//not a conversion, it is sent as it is, the end of the format too
+				format--;
+				while(conversion <= format)
+				{
+					SWUART_error = SWUART_channelSend(channel, (uint8_t)*conversion);
+					conversion++;
+				}
+				break;
+		}
+	}
+	return SWUART_error;
+}
+
+
+En_SWUART_Error_t SWUART_channelPrintf(uint8_t channel, const char *format, ...)
+{
+	En_SWUART_Error_t SWUART_error;
+	va_list args;
+	va_start(args, format);
+	SWUART_error = SWUART_channelVprintf(channel, format, args);
+	va_end(args);
+	return SWUART_error;
+}
+
+
+void SWUART_printString(const char *string)
+{
+	SWUART_channelPrintString(SWUART_DEFAULT_CHANNEL, string);
+}
+
+
+void SWUART_printU32(uint32_t value)
+{
+	SWUART_channelPrintU32(SWUART_DEFAULT_CHANNEL, value);
+}
+
+
+void SWUART_printS32(sint32_t value)
+{
+	SWUART_channelPrintS32(SWUART_DEFAULT_CHANNEL, value);
+}
+
+
+void SWUART_printS16(sint16_t value)
+{
+	SWUART_channelPrintS32(SWUART_DEFAULT_CHANNEL, value);
+}
+
+
+void SWUART_printHex(uint32_t value, uint8_t digits)
+{
+	SWUART_channelPrintHex(SWUART_DEFAULT_CHANNEL, value, digits);
+}
+
+
+void SWUART_printf(const char *format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	SWUART_channelVprintf(SWUART_DEFAULT_CHANNEL, format, args);
+	va_end(args);
+}
+
+
+//////////////////////////////////////////////////////////
@@ -0,0 +1,112 @@
+//############# SWUARTPrint.h ##############
+
+#ifndef SWUARTPRINT_H_
+#define SWUARTPRINT_H_
+
+#include "SWUART.h"
+
+/*
+ * Formatted output on top of the SW UART channels, without sprintf and its float support.
+ * The characters go straight into the transmit buffer with SWUART_channelSend, waiting whenever it is full,
+ * there is no intermediate buffer.
+ * The decimal digits are made most significant first by subtracting the powers of ten from a table in the flash,
+ * in 16 bit once the value is below 10000, so there is no division, which the AVR does in software.
+ */
+#if SWUART_DATA_BITS < 7
+#error "the printed characters are ASCII, build them with 7 or more data bits"
+#endif
+
+#ifdef HOST_SIM
+/*
+ * Compares of the value with the powers of ten in 32 bit and in 16 bit, with the subtractions they take,
+ * counted only in the host build for the benchmark in Simulator/print.c.
+ */
+extern uint32_t SWUART_printLongSteps;
+extern uint32_t SWUART_printShortSteps;
+#endif
+
+/*
+ * channel: is an input argument that describes the channel number.
+ * string: is an input argument that describes the null terminated string to be sent, without its null.
+ * It returns SWUART_OK or SWUART_WRONG_CHANNEL.
+ */
+ En_SWUART_Error_t SWUART_channelPrintString(uint8_t channel, const char *string);
+
+/*
+ * channel: is an input argument that describes the channel number.
+ * value: is an input argument that describes the number to be sent in decimal, without leading zeros.
+ * It returns SWUART_OK or SWUART_WRONG_CHANNEL.
+ */
+ En_SWUART_Error_t SWUART_channelPrintU32(uint8_t channel, uint32_t value);
+
+/*
+ * channel: is an input argument that describes the channel number.
+ * value: is an input argument that describes the number to be sent in decimal, with a '-' if it is negative.
+ * It returns SWUART_OK or SWUART_WRONG_CHANNEL.
+ */
+ En_SWUART_Error_t SWUART_channelPrintS32(uint8_t channel, sint32_t value);
+
+/*
+ * channel: is an input argument that describes the channel number.
+ * value: is an input argument that describes the number to be sent in decimal, with a '-' if it is negative.
+ * It returns SWUART_OK or SWUART_WRONG_CHANNEL.
+ */
+ En_SWUART_Error_t SWUART_channelPrintS16(uint8_t channel, sint16_t value);
+
+/*
+ * channel: is an input argument that describes the channel number.
+ * value: is an input argument that describes the number to be sent in upper case hexadecimal, without a 0x.
+ * digits: is an input argument that describes the least number of digits, filled with leading zeros,
+ * 0 sends only the digits needed.
+ * It returns SWUART_OK or SWUART_WRONG_CHANNEL.
+ */
+ En_SWUART_Error_t SWUART_channelPrintHex(uint8_t channel, uint32_t value, uint8_t digits);
+
+/*
+ * channel: is an input argument that describes the channel number.
+ * format: is an input argument that describes the text to be sent, with conversions for the arguments after it.
+ * The conversions are %[0][width][l]type, type is one of:
+ * c: a character, s: a string, d or i: a signed int, u: an unsigned int, x or X: an unsigned int in lower or
+ * upper case hexadecimal, %: a '%'.
+ * l takes a long for d, i, u, x and X, width pads the conversion on the left with spaces, or zeros after a 0 flag.
+ * There is no float, precision or left alignment, another type is sent as it is with its '%'.
+ * It returns SWUART_OK or SWUART_WRONG_CHANNEL.
+ */
+ En_SWUART_Error_t SWUART_channelPrintf(uint8_t channel, const char *format, ...);
+
+/*
+ * string: is an input argument that describes the null terminated string to be sent on the default channel.
+ */
+ void SWUART_printString(const char *string);
+
+/*
+ * value: is an input argument that describes the number to be sent in decimal on the default channel.
+ */
+ void SWUART_printU32(uint32_t value);
+
+/*
+ * value: is an input argument that describes the number to be sent in decimal on the default channel.
+ */
+ void SWUART_printS32(sint32_t value);
+
+/*
+ * value: is an input argument that describes the number to be sent in decimal on the default channel.
+ */
+ void SWUART_printS16(sint16_t value);
+
+/*
+ * value: is an input argument that describes the number to be sent in hexadecimal on the default channel.
+ * digits: is an input argument that describes the least number of digits, 0 sends only the digits needed.
+ */
+ void SWUART_printHex(uint32_t value, uint8_t digits);
+
+/*
+ * format: is an input argument that describes the text to be sent on the default channel,
+ * with the conversions of SWUART_channelPrintf.
+ */
+ void SWUART_printf(const char *format, ...);
+
+ #endif //SWUARTPRINT_H_
+
+
+ //////////////////////////////////////////////////////////
@@ -0,0 +1,245 @@
+//############# TimerService.c ##############
+#include "TimerService.h"
+#include "../Interrupt/Interrupt.h"
+/**
+*@brief End of the timers list.
+*/
+#define TIMER_SERVICE_NONE	0xFF
+/*******************************************************************************************************************/
+/**
+*@brief <h3>Software timer</h3>
+*@details
+*\arg A running timer is linked in the list by next in the order of its deadline.
+*/
+typedef struct
+{
+	uint32_t deadline;					/**<timebase ticks of the next call*/
+	uint32_t period;					/**<ticks between the calls, 0 for a one-shot timer*/
+	TimerService_callback_t callback;	/**<function called at the deadline*/
+	uint8_t next;						/**<next timer in the list or #TIMER_SERVICE_NONE*/
+	uint8_t running;					/**<1 while the timer is in the list*/
+}ST_TimerService_timer_t;
+/*******************************************************************************************************************/
+/**
+*@var ST_TimerService_timer_t TimerService_globalTimers
+*@brief Global static table of the software timers
+*/
+static volatile ST_TimerService_timer_t TimerService_globalTimers[TIMER_SERVICE_NUM_OF_TIMERS];
+/*******************************************************************************************************************/
+/**
+*@var uint8_t TimerService_globalHead
+*@brief Global static variable for the timer with the nearest deadline
+*\details
+*\arg It is #TIMER_SERVICE_NONE while no timer is running, then a compare match costs a single comparison.
+*/
+static volatile uint8_t TimerService_globalHead = TIMER_SERVICE_NONE;
+/*******************************************************************************************************************/
+/**
+*@var TimerService_callback_t TimerService_globalClient
+*@brief Global static variable for the periodic client of #TimerService_setClient
+*/
+static volatile TimerService_callback_t TimerService_globalClient = 0;
+/*******************************************************************************************************************/
+/**
+*@var uint8_t TimerService_globalDispatching
+*@brief Global static flag set while the callbacks are called
+*\details
+*\arg The interrupts are already disabled then, so #TimerService_start and #TimerService_stop don't enable them.
+*/
+static volatile uint8_t TimerService_globalDispatching = 0;
+/*******************************************************************************************************************/
+//removes a running timer from the list
+static void TimerService_unlink(uint8_t timer)
+{
+	if (TimerService_globalHead == timer)
+	{
+		TimerService_globalHead = TimerService_globalTimers[timer].next;
+	}
+	else
+	{
+		uint8_t previous = TimerService_globalHead;
+		while (TimerService_globalTimers[previous].next != timer)
+		{
+			previous = TimerService_globalTimers[previous].next;
+		}
+		TimerService_globalTimers[previous].next = TimerService_globalTimers[timer].next;
+	}
+	TimerService_globalTimers[timer].running = 0;
+}
+/*******************************************************************************************************************/
+//links a timer after the timers with the same or an earlier deadline, so equal deadlines are called in start order
+static void TimerService_insert(uint8_t timer)
+{
+	uint32_t deadline = TimerService_globalTimers[timer].deadline;
+	uint8_t previous = TIMER_SERVICE_NONE;
+	uint8_t next = TimerService_globalHead;
+	//the deadlines are compared on their signed difference, so the count may wrap
+	while (next != TIMER_SERVICE_NONE && (sint32_t)(TimerService_globalTimers[next].deadline - deadline) <= 0)
+	{
+		previous = next;
+		next = TimerService_globalTimers[next].next;
+	}
+	TimerService_globalTimers[timer].next = next;
+	if (previous == TIMER_SERVICE_NONE)
+	{
+		TimerService_globalHead = timer;
+	}
+	else
+	{
+		TimerService_globalTimers[previous].next = timer;
+	}
+	TimerService_globalTimers[timer].running = 1;
+}
+/*******************************************************************************************************************/
+//calls the timers that reached their deadlines and sets the next match, the interrupts must be disabled
+static void TimerService_dispatch(void)
+{
+	uint8_t pending = 1;
+	TimerService_globalDispatching = 1;
+	while (pending)
+	{
+		uint8_t timer = TimerService_globalHead;
+		pending = 0;
+		if (timer != TIMER_SERVICE_NONE)
+		{
+			volatile ST_TimerService_timer_t *timerPtr = &TimerService_globalTimers[timer];
+			if ((sint32_t)(Timer0_getTicks() - timerPtr->deadline) >= 0)
+			{
+				//the timer leaves the list before its call, so the callback may restart or stop it
+				TimerService_globalHead = timerPtr->next;
+				timerPtr->running = 0;
+				if (timerPtr->period != 0)
+				{
+					timerPtr->deadline += timerPtr->period;
+					TimerService_insert(timer);
+				}
+				timerPtr->callback();
+				pending = 1;
+			}
+			else if (!Timer0_isPeriodic())
+			{
+				Timer0_compareAt(timerPtr->deadline);
+				//a deadline reached while OCR0 was written is only matched after the counter wraps
+				pending = (sint32_t)(Timer0_getTicks() - timerPtr->deadline) >= 0;
+			}
+		}
+	}
+	//no match is needed without timers and client
+	if (TimerService_globalHead == TIMER_SERVICE_NONE && TimerService_globalClient == 0)
+	{
+		Timer0_interruptDiable(TIMER0_OUT_CMP_MATCH_INT);
+	}
+	TimerService_globalDispatching = 0;
+}
+/*******************************************************************************************************************/
+En_TimerService_Error_t TimerService_init(EN_Timer0_clkSource_t Timer0_clkSource)
+{
+	En_TimerService_Error_t TimerService_error = TIMER_SERVICE_OK;
+	//a running client keeps its prescaler
+	if (!Timer0_isPeriodic() && Timer0_initTimebase(Timer0_clkSource) != TIMER0_OK)
+	{
+		TimerService_error = TIMER_SERVICE_WRONG_CLK_SOURCE;
+	}
+	return TimerService_error;
+}
+/*******************************************************************************************************************/
+void TimerService_setClient(TimerService_callback_t client)
+{
+	cli();
+	TimerService_globalClient = client;
+	if (client == 0)
+	{
+		//the timers go on from the over flows and the nearest deadline,
+		//Timer0_stopPeriodic leaves the interrupts disabled for the dispatch
+		Timer0_stopPeriodic();
+		TimerService_dispatch();
+	}
+	sei();
+}
+/*******************************************************************************************************************/
+En_TimerService_Error_t TimerService_start(uint8_t timer, uint32_t ticks, uint32_t periodTicks, TimerService_callback_t callback)
+{
+	En_TimerService_Error_t TimerService_error = TIMER_SERVICE_OK;
+	if (timer >= TIMER_SERVICE_NUM_OF_TIMERS)
+	{
+		TimerService_error = TIMER_SERVICE_WRONG_TIMER;
+	}
+	else if (callback == 0)
+	{
+		TimerService_error = TIMER_SERVICE_WRONG_CALLBACK;
+	}
+	else
+	{
+		uint8_t dispatching = TimerService_globalDispatching;
+		volatile ST_TimerService_timer_t *timerPtr = &TimerService_globalTimers[timer];
+		cli();
+		if (timerPtr->running)
+		{
+			TimerService_unlink(timer);
+		}
+		timerPtr->deadline = Timer0_getTicks() + ticks;
+		timerPtr->period = periodTicks;
+		timerPtr->callback = callback;
+		TimerService_insert(timer);
+		//a callback is already called from the dispatch, that sets the match when it returns
+		if (!dispatching)
+		{
+			if (!Timer0_isPeriodic())
+			{
+				TimerService_dispatch();
+			}
+			if (TimerService_globalHead != TIMER_SERVICE_NONE)
+			{
+				Timer0_interruptEnable(TIMER0_OUT_CMP_MATCH_INT);
+			}
+			sei();
+		}
+	}
+	return TimerService_error;
+}
+/*******************************************************************************************************************/
+En_TimerService_Error_t TimerService_stop(uint8_t timer)
+{
+	En_TimerService_Error_t TimerService_error = TIMER_SERVICE_OK;
+	if (timer >= TIMER_SERVICE_NUM_OF_TIMERS)
+	{
+		TimerService_error = TIMER_SERVICE_WRONG_TIMER;
+	}
+	else
+	{
+		uint8_t dispatching = TimerService_globalDispatching;
+		cli();
+		if (TimerService_globalTimers[timer].running)
+		{
+			TimerService_unlink(timer);
+		}
+		if (!dispatching)
+		{
+			sei();
+		}
+	}
+	return TimerService_error;
+}
+/*******************************************************************************************************************/
+uint8_t TimerService_isRunning(uint8_t timer)
+{
+	return timer < TIMER_SERVICE_NUM_OF_TIMERS && TimerService_globalTimers[timer].running;
+}
+/*******************************************************************************************************************/
+ISR(TIM0_COMP)
+{
+	TimerService_callback_t client = TimerService_globalClient;
+	if (client != 0)
+	{
+		Timer0_nextCompare();
+		client();
+	}
+	//a single comparison while the nearest deadline isn't reached
+	if (TimerService_globalHead != TIMER_SERVICE_NONE)
+	{
+		TimerService_dispatch();
+	}
+}
+
+
+//////////////////////////////////////////////////////////
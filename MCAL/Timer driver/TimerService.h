@@ -0,0 +1,123 @@
+//############# TimerService.h ##############
+
+#ifndef TIMER_SERVICE_H_
+#define TIMER_SERVICE_H_
+#include "Timer_0.h"
+/******************************************************************************************************/
+/**
+*\defgroup Timer_service	Timer service
+*\ingroup Timers_driver
+*\details
+*\arg The timer service shares the compare match of Timer 0 between a periodic client and software timers.
+*\arg The client, the SW UART bit clock, is called on every match of #Timer0_initPeriodic.
+*\arg The software timers are one-shot or periodic callbacks on the ticks of the Timer 0 timebase, kept in a list\n
+sorted by their deadlines, so a match only compares the nearest deadline whatever the number of timers.
+*\arg Without a client the timebase runs from #Timer0_initTimebase and #OCR0 is set to the nearest deadline.
+*\arg The service owns the compare match ISR of Timer 0.
+*@{
+*/
+/******************************************************************************************************/
+/**
+*@brief Number of software timers.
+*\details
+*\arg The timers are numbered from 0, every timer takes 12 bytes of RAM.
+*/
+#ifndef TIMER_SERVICE_NUM_OF_TIMERS
+#define TIMER_SERVICE_NUM_OF_TIMERS	4
+#endif
+/******************************************************************************************************/
+/**
+*@brief <h3>Timer service callback</h3>
+*@details
+*\arg The callbacks are called from the compare match ISR with the interrupts disabled, so they must be short.
+*\arg A deadline already reached when #TimerService_start returns is called from it, also with the interrupts disabled.
+*/
+typedef void (*TimerService_callback_t)(void);
+/******************************************************************************************************/
+/**
+*@brief <h3>Timer service errors</h3>
+*@details
+*\arg This enum contains the values for the timer service errors.
+*/
+typedef enum
+{
+	TIMER_SERVICE_OK,				/**<enum value shows that the timer service parameters are correct*/
+	TIMER_SERVICE_WRONG_TIMER,		/**<enum value shows that the timer number is wrong*/
+	TIMER_SERVICE_WRONG_CALLBACK,	/**<enum value shows that the callback is missing*/
+	TIMER_SERVICE_WRONG_CLK_SOURCE	/**<enum value shows that the timebase clock source is wrong*/
+}En_TimerService_Error_t;
+/******************************************************************************************************/
+/**
+*@brief <h3>Timer service init</h3>
+*@details
+*\arg This function starts the timebase of #Timer0_initTimebase if Timer 0 isn't already running periodic compare matches.
+*\arg The ticks of the software timers are ticks of this clock source, a client opened later with another\n
+prescaler changes their length, so the client is opened first.
+
+*@param[in] Timer0_clkSource The clock source for Timer 0, one of the prescaled internal sources of #EN_Timer0_clkSource_t.
+
+*@retval TIMER_SERVICE_OK				If the timebase is running.
+*@retval TIMER_SERVICE_WRONG_CLK_SOURCE If the clock source isn't a prescaled internal source.
+*/
+En_TimerService_Error_t TimerService_init(EN_Timer0_clkSource_t Timer0_clkSource);
+/******************************************************************************************************/
+/**
+*@brief <h3>Timer service set client</h3>
+*@details
+*\arg This function sets the function called on every compare match of #Timer0_initPeriodic, before the software timers.
+*\arg The client starts the periodic compare matches itself and enables the compare match interrupt.
+*\arg A null client stops the periodic compare matches with #Timer0_stopPeriodic, the compare match interrupt\n
+stays enabled only while software timers are running.
+
+*@param[in] client The function called on every compare match, or null.
+*/
+void TimerService_setClient(TimerService_callback_t client);
+/******************************************************************************************************/
+/**
+*@brief <h3>Timer service start</h3>
+*@details
+*\arg This function starts a software timer, or restarts it if it is running.
+*\arg The callback is called when the timebase reaches ticks from now, then every periodTicks if periodTicks isn't 0.
+*\arg The next deadline of a periodic timer is the last one plus periodTicks, so a late call doesn't delay the next ones.
+*\arg With a client the deadlines are checked on its compare matches, so they are rounded up to the client tick.
+*\arg It can be called from a callback, also for its own timer.
+
+*@param[in] timer The timer number, 0 to #TIMER_SERVICE_NUM_OF_TIMERS-1.
+*@param[in] ticks Timebase ticks to the first call, up to 2^31-1.
+*@param[in] periodTicks Timebase ticks between the calls, 0 for a one-shot timer.
+*@param[in] callback The function called at the deadlines.
+
+*@retval TIMER_SERVICE_OK				If the timer is started.
+*@retval TIMER_SERVICE_WRONG_TIMER		If the timer number is wrong.
+*@retval TIMER_SERVICE_WRONG_CALLBACK	If the callback is null.
+*/
+En_TimerService_Error_t TimerService_start(uint8_t timer, uint32_t ticks, uint32_t periodTicks, TimerService_callback_t callback);
+/******************************************************************************************************/
+/**
+*@brief <h3>Timer service stop</h3>
+*@details
+*\arg This function stops a software timer, a stopped timer is left alone.
+*\arg It can be called from a callback, also for its own timer.
+
+*@param[in] timer The timer number, 0 to #TIMER_SERVICE_NUM_OF_TIMERS-1.
+
+*@retval TIMER_SERVICE_OK			If the timer is stopped.
+*@retval TIMER_SERVICE_WRONG_TIMER	If the timer number is wrong.
+*/
+En_TimerService_Error_t TimerService_stop(uint8_t timer);
+/******************************************************************************************************/
+/**
+*@brief <h3>Timer service is running</h3>
+*@details
+*\arg This function tells if a software timer is waiting for a deadline, a one-shot timer stops before its call.
+
+*@param[in] timer The timer number, 0 to #TIMER_SERVICE_NUM_OF_TIMERS-1.
+
+*@retval uint8_t 1 if the timer is running, 0 if it is stopped or the timer number is wrong.
+*/
+uint8_t TimerService_isRunning(uint8_t timer);
+/**@}*/
+#endif /* TIMER_SERVICE_H_ */
+
+
+//////////////////////////////////////////////////////////
@@ -4,7 +4,6 @@
 /*															File name: Timer_0.c																	*/
 /****************************************************************************************************************************************************/
 #include "Timer_0.h"
-#include <math.h>
 #include "../Interrupt/Interrupt.h"
 /**
 *\var EN_Timer0_clkSource_t Timer0_globalClkSource
@@ -25,19 +24,67 @@ it will be used by #ISR.
 static uint32_t volatile Timer0_globalNumOfOverFlows = 0;
 /*******************************************************************************************************************/
 /**
-*@var float64_t volatile Timer0_globalOverFlowTime
-*@brief Global static variable for Timer 0 over flow time
+*@var uint16_t Timer0_globalClkPrescaler
+*@brief Global static table for Timer 0 prescalers
 *\details
-*\arg This variable stores the time for one over flow.
+*\arg This table stores the division factor of each internal clock source, indexed by #EN_Timer0_clkSource_t.
 */
-static float64_t volatile Timer0_globalOverFlowTime = 0;
+static const uint16_t Timer0_globalClkPrescaler[] = {0,1,8,64,256,1024};
+/*******************************************************************************************************************/
+/**
+*@name Timebase states
+*\details
+*\arg The free running timebase is stopped, extended by the over flows of #Timer0_initTimebase,\n
+or extended by the periodic compare matches of #Timer0_initPeriodic.
+*/
+///@{
+#define TIMER0_TIMEBASE_OFF			0
+#define TIMER0_TIMEBASE_OVER_FLOWS	1
+#define TIMER0_TIMEBASE_COMPARE		2
+///@}
+/*******************************************************************************************************************/
+/**
+*@var uint8_t Timer0_globalTimebase
+*@brief Global static state of the free running timebase
+*\details
+*\arg This variable is set by #Timer0_initTimebase and #Timer0_initPeriodic and cleared by #Timer0_stop,\n
+while it isn't #TIMER0_TIMEBASE_OFF #TCNT0 is never reset, so #Timer0_now is monotonic.
+*/
+static volatile uint8_t Timer0_globalTimebase = TIMER0_TIMEBASE_OFF;
+/*******************************************************************************************************************/
+/**
+*@var uint16_t Timer0_globalComparePeriod
+*@brief Global static variable for the periodic compare match period
+*\details
+*\arg This variable stores the ticks between two compare matches that #Timer0_nextCompare adds to #OCR0, 1 to 256.
+*/
+static uint16_t Timer0_globalComparePeriod = TIMER0_NUM_OF_TICKS;
+/*******************************************************************************************************************/
+/**
+*@var uint16_t Timer0_globalNextComparePeriod
+*@brief Global static variable for the period of the matches after the next one
+*\details
+*\arg This variable is set by #Timer0_initPeriodic and #Timer0_setPeriodicFrequency, #Timer0_nextCompare moves it to\n
+#Timer0_globalComparePeriod at the match, so a new period starts on the grid of the old one.
+*/
+static volatile uint16_t Timer0_globalNextComparePeriod = TIMER0_NUM_OF_TICKS;
+/*******************************************************************************************************************/
+/**
+*@var uint32_t Timer0_globalClock
+*@brief Global static variable for the calibrated system clock
+*\details
+*\arg This variable stores the system clock in hertz set by #Timer0_setClock, 0 until then, and #SYSTEM_CLK is used.
+*/
+static uint32_t Timer0_globalClock = 0;
+/*******************************************************************************************************************/
 /**
-*@var float64_t volatile Timer0_globalTickTime
-*@brief Global static variable for Timer 0 tick time
+*@var uint32_t Timer0_globalCompareTicks
+*@brief Global static variable for the timebase ticks at the last compare match
 *\details
-*\arg This variable stores the time for one tick.
+*\arg With a periodic compare match the timebase is extended by #Timer0_nextCompare instead of the over flow ISR,\n
+so the bit clock of a driver isn't delayed by a second interrupt.
 */
-static float64_t volatile Timer0_globalTickTime = 0;
+static volatile uint32_t Timer0_globalCompareTicks = 0;
 /*******************************************************************************************************************/
 En_Timer0_Error_t Timer0_init(EN_Timer0_Mode_t Timer0_mode,EN_Timer0_clkSource_t Timer0_clkSource)
 {
@@ -59,13 +106,6 @@ En_Timer0_Error_t Timer0_init(EN_Timer0_Mode_t Timer0_mode,EN_Timer0_clkSource_t
 	if (Timer0_clkSource >= NO_CLOCK_SOURCE && Timer0_clkSource <= EXTERNAL_CLOCK_RISING_EDGE)
 	{
 		Timer0_globalClkSource = Timer0_clkSource;
-		
-		
-		uint16_t Timer0_localClkPrescaler[] = {0,1,8,64,256,1024};
-		//calculate Timer 0 tick time
-		Timer0_globalTickTime = (float64_t)Timer0_localClkPrescaler[Timer0_clkSource]/SYSTEM_CLK;
-		//calculate Timer 0 over flow time
-		Timer0_globalOverFlowTime = Timer0_globalTickTime * TIMER0_NUM_OF_TICKS;
 	} 
 	else
 	{
@@ -74,6 +114,157 @@ En_Timer0_Error_t Timer0_init(EN_Timer0_Mode_t Timer0_mode,EN_Timer0_clkSource_t
 	return Timer0_error;
 }
 /*******************************************************************************************************************/
+/**
+*@brief Number of ticks in one period of the needed frequency for a clock source, rounded to the nearest tick.
+*/
+static uint32_t Timer0_periodTicks(EN_Timer0_clkSource_t Timer0_clkSource, uint32_t frequency)
+{
+	uint32_t clkFrequency = frequency * Timer0_globalClkPrescaler[Timer0_clkSource];
+	return (Timer0_getClock() + clkFrequency/2)/clkFrequency;
+}
+/*******************************************************************************************************************/
+/**
+*@brief The smallest prescaler that fits one period of the frequency in the counter, as it gives the best resolution.
+*/
+static EN_Timer0_clkSource_t Timer0_clkSourceOf(uint32_t frequency)
+{
+	EN_Timer0_clkSource_t Timer0_clkSource = clkI_No_DIVISON;
+	while (Timer0_clkSource < clkI_DIVISION_BY_1024 && Timer0_periodTicks(Timer0_clkSource,frequency) > TIMER0_NUM_OF_TICKS)
+	{
+		Timer0_clkSource++;
+	}
+	return Timer0_clkSource;
+}
+/*******************************************************************************************************************/
+En_Timer0_Error_t Timer0_initTimebase(EN_Timer0_clkSource_t Timer0_clkSource)
+{
+	En_Timer0_Error_t Timer0_error = TIMER0_OK;
+	if (Timer0_clkSource < clkI_No_DIVISON || Timer0_clkSource > clkI_DIVISION_BY_1024)
+	{
+		Timer0_error = TIMER0_WRONG_CLK_SOURCE;
+	}
+	else
+	{
+		//the counter keeps its value, so the time goes on from where it was,
+		//the interrupt flag is restored as the caller had it, a caller with the interrupts disabled keeps them disabled
+		uint8_t sreg = SREG;
+		cli();
+		//an over flow flag left pending is counted by the ISR once it is enabled
+		Timer0_globalNumOfOverFlows = Timer0_getTicks() / TIMER0_NUM_OF_TICKS - getBit(TIFR,TOV0);
+		Timer0_globalTimebase = TIMER0_TIMEBASE_OVER_FLOWS;
+		Timer0_init(NORMAL,Timer0_clkSource);
+		Timer0_start();
+		setBit(TIMSK,TIMER0_OVER_FLOW_INT);
+		SREG = sreg;
+	}
+	return Timer0_error;
+}
+/*******************************************************************************************************************/
+En_Timer0_Error_t Timer0_initPeriodic(EN_Timer0_clkSource_t Timer0_clkSource, uint32_t frequency)
+{
+	En_Timer0_Error_t Timer0_error = TIMER0_OK;
+	if (Timer0_clkSource < clkI_No_DIVISON || Timer0_clkSource > clkI_DIVISION_BY_1024)
+	{
+		Timer0_error = TIMER0_WRONG_CLK_SOURCE;
+	}
+	else if (frequency == 0)
+	{
+		Timer0_error = TIMER0_WRONG_FREQUENCY;
+	}
+	else
+	{
+		uint32_t periodTicks = Timer0_periodTicks(Timer0_clkSource,frequency);
+		if (periodTicks == 0 || periodTicks > TIMER0_NUM_OF_TICKS)
+		{
+			Timer0_error = TIMER0_WRONG_FREQUENCY;
+		}
+		else
+		{
+			cli();
+			//the time goes on from where it was, counted from the last match
+			Timer0_globalCompareTicks = Timer0_getTicks();
+			Timer0_globalComparePeriod = periodTicks;
+			Timer0_globalNextComparePeriod = periodTicks;
+			Timer0_globalTimebase = TIMER0_TIMEBASE_COMPARE;
+			Timer0_interruptDiable(TIMER0_OVER_FLOW_INT);
+			Timer0_init(NORMAL,Timer0_clkSource);
+			Timer0_start();
+			//the first match is one period from now, a count left above OCR0 doesn't delay it,
+			//the low byte of the ticks is the count, so the last match is now
+			OCR0 = (uint8_t)Timer0_globalCompareTicks + periodTicks;
+			sei();
+		}
+	}
+	return Timer0_error;
+}
+/*******************************************************************************************************************/
+En_Timer0_Error_t Timer0_initPeriodicFrequency(uint32_t frequency)
+{
+	En_Timer0_Error_t Timer0_error = TIMER0_WRONG_FREQUENCY;
+	if (frequency != 0)
+	{
+		Timer0_error = Timer0_initPeriodic(Timer0_clkSourceOf(frequency),frequency);
+	}
+	return Timer0_error;
+}
+/*******************************************************************************************************************/
+En_Timer0_Error_t Timer0_checkPeriodicFrequency(uint32_t frequency)
+{
+	En_Timer0_Error_t Timer0_error = TIMER0_WRONG_FREQUENCY;
+	if (frequency != 0)
+	{
+		uint32_t periodTicks = Timer0_periodTicks(Timer0_clkSourceOf(frequency),frequency);
+		if (periodTicks != 0 && periodTicks <= TIMER0_NUM_OF_TICKS)
+		{
+			Timer0_error = TIMER0_OK;
+		}
+	}
+	return Timer0_error;
+}
+/*******************************************************************************************************************/
+En_Timer0_Error_t Timer0_setPeriodicFrequency(uint32_t frequency)
+{
+	En_Timer0_Error_t Timer0_error = TIMER0_OK;
+	uint32_t periodTicks = frequency == 0 ? 0 : Timer0_periodTicks(Timer0_globalClkSource,frequency);
+	if (Timer0_globalTimebase != TIMER0_TIMEBASE_COMPARE || periodTicks == 0 || periodTicks > TIMER0_NUM_OF_TICKS)
+	{
+		Timer0_error = TIMER0_WRONG_FREQUENCY;
+	}
+	else
+	{
+		Timer0_globalNextComparePeriod = periodTicks;
+	}
+	return Timer0_error;
+}
+/*******************************************************************************************************************/
+void Timer0_nextCompare(void)
+{
+	//the next match is scheduled from the last one, not from now, so the ISR latency doesn't add up
+	Timer0_globalCompareTicks += Timer0_globalComparePeriod;
+	Timer0_globalComparePeriod = Timer0_globalNextComparePeriod;
+	OCR0 += Timer0_globalComparePeriod;
+}
+/*******************************************************************************************************************/
+void Timer0_stopPeriodic(void)
+{
+	if (Timer0_globalTimebase == TIMER0_TIMEBASE_COMPARE)
+	{
+		//the count goes on from the over flows with the same clock source
+		Timer0_initTimebase(Timer0_globalClkSource);
+	}
+}
+/*******************************************************************************************************************/
+uint8_t Timer0_isPeriodic(void)
+{
+	return Timer0_globalTimebase == TIMER0_TIMEBASE_COMPARE;
+}
+/*******************************************************************************************************************/
+void Timer0_compareAt(uint32_t ticks)
+{
+	//the low byte of the timebase ticks is the count
+	OCR0 = (uint8_t)ticks;
+}
+/*******************************************************************************************************************/
 void Timer0_start(void)
 {
 	//clear the old clock source value
@@ -87,6 +278,7 @@ void Timer0_stop(void)
 	//clear the value of Timer 0 clock source 
 	//this is done by clearing the three bits #CS00, #CS01 and #CS02
 	TCCR0 &= CLR_TIMER0_CLK_SRC;
+	Timer0_globalTimebase = TIMER0_TIMEBASE_OFF;
 }
 /*******************************************************************************************************************/
 void Timer0_reset(void)
@@ -124,22 +316,119 @@ En_Timer0_Error_t Timer0_interruptEnable(TIMER0_interrupt_t Timer0_interrupt)
 	return Timer0_error;
 }
 /*******************************************************************************************************************/
+void Timer0_setClock(uint32_t clock)
+{
+	Timer0_globalClock = clock;
+}
+/*******************************************************************************************************************/
+uint32_t Timer0_getClock(void)
+{
+	return Timer0_globalClock != 0 ? Timer0_globalClock : SYSTEM_CLK;
+}
+/*******************************************************************************************************************/
+uint16_t Timer0_getPrescaler(void)
+{
+	uint16_t prescaler = 0;
+	if (Timer0_globalClkSource >= clkI_No_DIVISON && Timer0_globalClkSource <= clkI_DIVISION_BY_1024)
+	{
+		prescaler = Timer0_globalClkPrescaler[Timer0_globalClkSource];
+	}
+	return prescaler;
+}
+/*******************************************************************************************************************/
+uint32_t Timer0_getTicks(void)
+{
+	uint32_t Timer0_ticks;
+	uint8_t ticks = TCNT0;
+	if (Timer0_globalTimebase == TIMER0_TIMEBASE_COMPARE)
+	{
+		uint8_t pending = getBit(TIFR,OCF0);
+		if (pending)
+		{
+			//the count read before the flag may be from before the match
+			ticks = TCNT0;
+		}
+		//ticks since the last match counted by Timer0_nextCompare, OCR0 is still one period after it
+		uint16_t elapsed = (uint8_t)(ticks - (uint8_t)(OCR0 - Timer0_globalComparePeriod));
+		//a match that is still pending is at least a period ago, a smaller count has wrapped
+		if (pending && elapsed < Timer0_globalComparePeriod)
+		{
+			elapsed += TIMER0_NUM_OF_TICKS;
+		}
+		Timer0_ticks = Timer0_globalCompareTicks + elapsed;
+	}
+	else
+	{
+		uint32_t overFlows = Timer0_globalNumOfOverFlows;
+		//an over flow that happened while the interrupts are disabled isn't counted by the ISR yet
+		if (getBit(TIFR,TOV0) && ticks < TIMER0_NUM_OF_TICKS/2)
+		{
+			overFlows++;
+		}
+		Timer0_ticks = overFlows * TIMER0_NUM_OF_TICKS + ticks;
+	}
+	return Timer0_ticks;
+}
+/*******************************************************************************************************************/
+uint32_t Timer0_now(void)
+{
+	cli();
+	uint32_t ticks = Timer0_getTicks();
+	sei();
+	return ticks;
+}
+/*******************************************************************************************************************/
+void Timer0_waitUntil(uint32_t deadline)
+{
+	sint32_t ticksLeft;
+	//the difference is signed, so the deadline may be after the 32 bit count wraps
+	while ((ticksLeft = (sint32_t)(deadline - Timer0_now())) > 0)
+	{
+		//the over flow wakes the CPU every counter period, so it sleeps only while a whole period is left
+		if (ticksLeft >= TIMER0_NUM_OF_TICKS)
+		{
+			sleep_idle();
+		}
+	}
+}
+/*******************************************************************************************************************/
 void Timer0_delay_ms(uint32_t delay_ms)
 {
+	//the delay is calculated only for the internal clock sources
+	if (Timer0_globalClkSource < clkI_No_DIVISON || Timer0_globalClkSource > clkI_DIVISION_BY_1024)
+	{
+		return;
+	}
+	//calculate number of ticks needed to reach the desired time
+	uint32_t neededTicks = (Timer0_getClock()/1000) * delay_ms / Timer0_globalClkPrescaler[Timer0_globalClkSource];
+	//the running timebase is only waited on, it isn't reset or stopped
+	if (Timer0_globalTimebase)
+	{
+		Timer0_waitUntil(Timer0_now() + neededTicks);
+		return;
+	}
 	//reset Timer 0
 	Timer0_reset();
-	//convert delay time from mile seconds to seconds
-	float64_t neededTimeInsecond = (float64_t)delay_ms/1000;
 	//calculate number of over flows needed to reach the desired time
-	uint32_t numberOfoverFlows = ceil(neededTimeInsecond/Timer0_globalOverFlowTime);
-	//calculate the initial value for #TCNT0 register
-	TCNT0 = TIMER0_NUM_OF_TICKS -(neededTimeInsecond/Timer0_globalTickTime)/numberOfoverFlows;
+	uint32_t numberOfoverFlows = (neededTicks + TIMER0_NUM_OF_TICKS - 1) / TIMER0_NUM_OF_TICKS;
+	//the first over flow is shortened by the initial value of #TCNT0, so the total is exactly the needed ticks
+	TCNT0 = numberOfoverFlows * TIMER0_NUM_OF_TICKS - neededTicks;
 	//enable Timer 0 over flow interrupt
 	Timer0_interruptEnable(TIMER0_OVER_FLOW_INT);
 	//start Timer 0 to count
 	Timer0_start();
-	//wait until reaching needed number over flows
-	while(Timer0_globalNumOfOverFlows < numberOfoverFlows);
+	//wait until reaching needed number over flows, the over flows are the only interrupt that wakes the CPU,
+	//so the count is checked with the interrupts disabled and SEI takes effect only after the sleep instruction
+	cli();
+	while(Timer0_globalNumOfOverFlows < numberOfoverFlows)
+	{
+		sleep_enable();
+		sei();
+		sleep_cpu();
+		sleep_disable();
+		cli();
+	}
+	sei();
 	//stop Timer 0 after reaching the desired time.
 	Timer0_stop();
 }
@@ -205,7 +205,8 @@ typedef enum
 	TIMER0_OK,		 /**<enum value shows that timer 0 parameters are correct*/
 	TIMER0_WRONG_MODE,		 /**<enum value shows that timer 0 mode is wrong*/
 	TIMER0_WRONG_CLK_SOURCE, /**<enum value shows that timer 0 clock source is wrong*/
-	TIMER0_WRONG_INT/**<enum value shows that timer 0 interrupt number is wrong*/
+	TIMER0_WRONG_INT,/**<enum value shows that timer 0 interrupt number is wrong*/
+	TIMER0_WRONG_FREQUENCY/**<enum value shows that timer 0 compare frequency can't be generated*/
 }En_Timer0_Error_t;
 /******************************************************************************************************/
 /**
@@ -252,6 +253,118 @@ En_Timer0_Error_t Timer0_interruptDiable(TIMER0_interrupt_t Timer0_interrupt);
 En_Timer0_Error_t Timer0_init(EN_Timer0_Mode_t Timer0_mode,EN_Timer0_clkSource_t Timer0_clkSource);
 /******************************************************************************************************/
 /**
+*@brief <h3>Timer0 init timebase</h3>
+*@details
+*\arg This function starts Timer 0 as a free running timebase, in normal mode with the over flow interrupt enabled.
+*\arg The counter is never reset afterwards, #Timer0_now extends it to a monotonic 32 bit tick count\n
+until #Timer0_stop is called, and #Timer0_delay_ms waits on it without resetting it.
+*\arg Calling it again with another clock source changes the tick length from then on, the count goes on.
+*\arg It leaves the global interrupt flag as it found it, so the over flows are counted once the caller enables the interrupts.
+
+*@param[in] Timer0_clkSource The clock source for Timer 0, one of the prescaled internal sources of #EN_Timer0_clkSource_t.
+
+*@retval TIMER0_OK				 If the timebase is started.
+*@retval TIMER0_WRONG_CLK_SOURCE If the clock source isn't a prescaled internal source.
+*/
+En_Timer0_Error_t Timer0_initTimebase(EN_Timer0_clkSource_t Timer0_clkSource);
+/******************************************************************************************************/
+/**
+*@brief <h3>Timer0 init periodic compare</h3>
+*@details
+*\arg This function starts Timer 0 as the free running timebase of #Timer0_initTimebase and schedules compare matches\n
+at the needed frequency on it, rounding the period to the nearest tick.
+*\arg Unlike the CTC mode the counter isn't cleared on the match, the compare ISR calls\n
+#Timer0_nextCompare to move #OCR0 one period after the last match, so the matches stay on an absolute grid.
+*\arg The timebase is extended by #Timer0_nextCompare, the over flow interrupt is disabled so it doesn't delay the matches.
+*\arg The compare match interrupt is not enabled here, it must be enabled before a whole counter period passes.
+
+*@param[in] Timer0_clkSource The clock source for Timer 0, one of the prescaled internal sources of #EN_Timer0_clkSource_t.
+*@param[in] frequency Compare match frequency in hertz.
+
+*@retval TIMER0_OK				 If the frequency can be generated.
+*@retval TIMER0_WRONG_CLK_SOURCE If the clock source isn't a prescaled internal source.
+*@retval TIMER0_WRONG_FREQUENCY If the frequency is 0 or its period doesn't fit in the counter with this clock source.
+*/
+En_Timer0_Error_t Timer0_initPeriodic(EN_Timer0_clkSource_t Timer0_clkSource, uint32_t frequency);
+/******************************************************************************************************/
+/**
+*@brief <h3>Timer0 init periodic compare frequency</h3>
+*@details
+*\arg This function is #Timer0_initPeriodic with the smallest prescaler that fits one period in the counter,\n
+as it gives the best resolution.
+
+*@param[in] frequency Compare match frequency in hertz.
+
+*@retval TIMER0_OK				 If the frequency can be generated.
+*@retval TIMER0_WRONG_FREQUENCY If the frequency is 0 or its period doesn't fit in the counter even with the largest prescaler.
+*/
+En_Timer0_Error_t Timer0_initPeriodicFrequency(uint32_t frequency);
+/******************************************************************************************************/
+/**
+*@brief <h3>Timer0 check periodic compare frequency</h3>
+*@details
+*\arg This function tells if #Timer0_initPeriodicFrequency can generate the frequency, with the same prescaler\n
+and period calculation, without touching Timer 0, so a running timebase isn't disturbed by the check.
+
+*@param[in] frequency Compare match frequency in hertz.
+
+*@retval TIMER0_OK				 If the frequency can be generated.
+*@retval TIMER0_WRONG_FREQUENCY If the frequency is 0 or its period doesn't fit in the counter even with the largest prescaler.
+*/
+En_Timer0_Error_t Timer0_checkPeriodicFrequency(uint32_t frequency);
+/******************************************************************************************************/
+/**
+*@brief <h3>Timer0 set periodic compare frequency</h3>
+*@details
+*\arg This function changes the frequency of the running #Timer0_initPeriodic with its clock source,\n
+the new period starts after the next match, so the matches go on without a gap or a jump.
+*\arg It is used to follow a new #Timer0_setClock, the period is calculated at the calibrated clock.
+
+*@param[in] frequency Compare match frequency in hertz.
+
+*@retval TIMER0_OK				 If the frequency can be generated.
+*@retval TIMER0_WRONG_FREQUENCY If the periodic compare isn't running, the frequency is 0 or its period doesn't fit\n
+in the counter with the running clock source.
+*/
+En_Timer0_Error_t Timer0_setPeriodicFrequency(uint32_t frequency);
+/******************************************************************************************************/
+/**
+*@brief <h3>Timer0 next compare</h3>
+*@details
+*\arg This function moves #OCR0 one period of #Timer0_initPeriodic after the last match and adds the period\n
+to the timebase, it must be called once from every compare match ISR.
+*/
+void Timer0_nextCompare(void);
+/******************************************************************************************************/
+/**
+*@brief <h3>Timer0 stop periodic compare</h3>
+*@details
+*\arg This function stops the compare matches of #Timer0_initPeriodic from extending the timebase,\n
+the over flow interrupt counts it again with the same clock source and the count goes on.
+*\arg It does nothing if #Timer0_initPeriodic isn't running.
+*/
+void Timer0_stopPeriodic(void);
+/******************************************************************************************************/
+/**
+*@brief <h3>Timer0 is periodic</h3>
+*@details
+*\arg This function tells if the compare matches of #Timer0_initPeriodic are running.
+*@retval uint8_t 1 if #OCR0 is moved by #Timer0_nextCompare, 0 if it is free to use.
+*/
+uint8_t Timer0_isPeriodic(void);
+/******************************************************************************************************/
+/**
+*@brief <h3>Timer0 compare at</h3>
+*@details
+*\arg This function sets #OCR0 to match when the timebase of #Timer0_initTimebase reaches the ticks.
+*\arg Only the low byte of the count is compared, so the match also comes at every wrap of the counter before,\n
+and a match already passed comes after the next wrap.
+*\arg It is used only while #Timer0_isPeriodic is 0.
+*@param[in] ticks The timebase tick count to match.
+*/
+void Timer0_compareAt(uint32_t ticks);
+/******************************************************************************************************/
+/**
 *@brief <h3>Timer0 start</h3>
 *@details
 *\arg This function starts Timer 0.
@@ -282,14 +395,76 @@ void Timer0_stop(void);
 void Timer0_reset(void);
 /******************************************************************************************************/
 /**
+*@brief <h3>Timer0 set clock</h3>
+*@details
+*\arg This function sets the system clock the periods and delays are calculated at, in place of #SYSTEM_CLK,\n
+for a clock measured against a known reference, like the internal RC oscillator off its nominal frequency.
+*\arg It takes effect on the next period or delay calculated, a running periodic compare follows it\n
+with #Timer0_setPeriodicFrequency.
+*@param[in] clock The system clock in hertz, 0 goes back to #SYSTEM_CLK.
+*/
+void Timer0_setClock(uint32_t clock);
+/******************************************************************************************************/
+/**
+*@brief <h3>Timer0 get clock</h3>
+*@details
+*\arg This function returns the system clock the periods and delays are calculated at.
+*@retval uint32_t The clock set by #Timer0_setClock, or #SYSTEM_CLK.
+*/
+uint32_t Timer0_getClock(void);
+/******************************************************************************************************/
+/**
+*@brief <h3>Timer0 get prescaler</h3>
+*@details
+*\arg This function returns the division factor of the clock source of Timer 0, the system clock cycles in a tick.
+*@retval uint16_t The prescaler, 0 if Timer 0 isn't clocked from the system clock.
+*/
+uint16_t Timer0_getPrescaler(void);
+/******************************************************************************************************/
+/**
+*@brief <h3>Timer0 get ticks</h3>
+*@details
+*\arg This function returns the ticks counted since #Timer0_reset in normal mode, extended to 32 bit by the\n
+over flows counted in the over flow ISR, so the over flow interrupt must be enabled.
+*\arg It must be called with the interrupts disabled, from an ISR or between cli() and sei(),\n
+an over flow that is still pending is added from #TOV0.
+*@param[in] void No input arguments.
+*@retval uint32_t The number of ticks.
+*/
+uint32_t Timer0_getTicks(void);
+/******************************************************************************************************/
+/**
+*@brief <h3>Timer0 now</h3>
+*@details
+*\arg This function returns the ticks of the timebase of #Timer0_initTimebase or #Timer0_initPeriodic, read atomically.
+*\arg It enables the interrupts when it returns, so an ISR calls #Timer0_getTicks instead.
+*@param[in] void No input arguments.
+*@retval uint32_t The number of ticks, it wraps around after 2^32 ticks.
+*/
+uint32_t Timer0_now(void);
+/******************************************************************************************************/
+/**
+*@brief <h3>Timer0 wait until</h3>
+*@details
+*\arg This function waits until #Timer0_now reaches the deadline, the CPU sleeps while a whole counter period is left.
+*\arg Deadlines are absolute, so waits scheduled one after the other as deadline += period don't add up their errors.
+*\arg A deadline already passed returns at once, the comparison is made on the signed difference so the count may wrap.
+*@param[in] deadline The tick count to wait for.
+*/
+void Timer0_waitUntil(uint32_t deadline);
+/******************************************************************************************************/
+/**
 *@brief <h3>Timer 0 delay</h3>
 *@details
 *\arg This function generates a delay in mile seconds using Timer 0.
+*\arg Timer 0 must be in normal mode, it counts the over flows with integer calculations only.
+*\arg If the timebase of #Timer0_initTimebase is running it waits on it, otherwise Timer 0 is reset and stopped after the delay.
+*\arg The CPU sleeps in the idle mode between the over flows, so it is awake only for their ISR.
 *@param[in] delay_ms Delay time in mile seconds.
 *@param[out] void No output arguments.
 *@retval void	This function doesn't return anything.
 */
-void Timer0_delay_ms(float64_t delay_ms);
+void Timer0_delay_ms(uint32_t delay_ms);
 /**@}*/
 #endif /* TIMER_0_H_ */
 
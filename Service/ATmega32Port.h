@@ -0,0 +1,55 @@
+#ifndef ATMEGA32PORT_H_
+#define ATMEGA32PORT_H_
+
+#include "RegisterFile.h"
+
+/**
+*\defgroup port_registers DIO ports registers
+*\ingroup registers
+*\details
+*\arg This contains the data, direction and input registers of the four ATmega32 ports.
+*\arg The ports are selected in the DIO driver by their character, 'A', 'B', 'C' or 'D'.
+*@{
+*/
+/**
+*@brief <h3>Port characters</h3>
+*\details
+*\arg This enum contains the characters that select a port in the DIO driver.
+*/
+typedef enum
+{
+	A = 'A',	/**<Port A*/
+	B = 'B',	/**<Port B*/
+	C = 'C',	/**<Port C*/
+	D = 'D'		/**<Port D*/
+}EN_port_t;
+
+#define PORTA	IO_REG8(0x3B)	/**<Port A Data Register*/
+#define DDRA	IO_REG8(0x3A)	/**<Port A Data Direction Register*/
+#define PINA	IO_REG8(0x39)	/**<Port A Input Pins Address*/
+
+#define PORTB	IO_REG8(0x38)	/**<Port B Data Register*/
+#define DDRB	IO_REG8(0x37)	/**<Port B Data Direction Register*/
+#define PINB	IO_REG8(0x36)	/**<Port B Input Pins Address*/
+
+#define PORTC	IO_REG8(0x35)	/**<Port C Data Register*/
+#define DDRC	IO_REG8(0x34)	/**<Port C Data Direction Register*/
+#define PINC	IO_REG8(0x33)	/**<Port C Input Pins Address*/
+
+#define PORTD	IO_REG8(0x32)	/**<Port D Data Register*/
+#define DDRD	IO_REG8(0x31)	/**<Port D Data Direction Register*/
+#define PIND	IO_REG8(0x30)	/**<Port D Input Pins Address*/
+
+/**
+*@brief <h3>Port register addresses</h3>
+*\details
+*\arg The registers of a port are PINx, DDRx and PORTx at consecutive addresses, port A is the highest and the next
+ports are 3 addresses lower.
+*\arg With a constant port character they are constants, so an access through #IO_REG8 compiles to a single instruction.
+*/
+#define PORT_ADDRESS(port)	(0x3B - 3*((port) - A))	/**<Data register address of port 'A' to 'D'*/
+#define DDR_ADDRESS(port)	(PORT_ADDRESS(port) - 1)	/**<Data direction register address of port 'A' to 'D'*/
+#define PIN_ADDRESS(port)	(PORT_ADDRESS(port) - 2)	/**<Input pins address of port 'A' to 'D'*/
+/**@}*/
+
+#endif /* ATMEGA32PORT_H_ */
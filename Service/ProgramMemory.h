@@ -0,0 +1,58 @@
+//############# ProgramMemory.h ##############
+
+#ifndef PROGRAMMEMORY_H_
+#define PROGRAMMEMORY_H_
+
+#include "dataTypes.h"
+
+/**
+*\defgroup program_memory Program memory
+*\ingroup Service
+*\details
+*\arg Constant tables marked #FLASH stay in the flash instead of being copied to the RAM at startup,
+they are read with #readFlashWord and #readFlashDword.
+*\arg In the host build (HOST_SIM defined) there is one memory, so #FLASH is empty and the tables are read directly.
+*@{
+*/
+#ifdef HOST_SIM
+#define FLASH
+#define readFlashWord(address)	(*(address))
+#define readFlashDword(address)	(*(address))
+#else
+/**
+*@brief Places a constant in the flash, as PROGMEM of avr-libc.
+*/
+#define FLASH	__attribute__((__progmem__))
+/**
+*@brief <h3>Read flash word</h3>
+*@details
+*\arg Reads a 16 bit word of a #FLASH table with two LPM instructions.
+*@param[in] address Address of the word in the flash.
+*@retval uint16_t the word.
+*/
+static inline uint16_t readFlashWord(const uint16_t *address)
+{
+	uint16_t word;
+	__asm__ ("lpm %A0, Z+" "\n\t" "lpm %B0, Z" : "=r" (word), "+z" (address));
+	return word;
+}
+/**
+*@brief <h3>Read flash double word</h3>
+*@details
+*\arg Reads a 32 bit word of a #FLASH table with four LPM instructions.
+*@param[in] address Address of the double word in the flash.
+*@retval uint32_t the double word.
+*/
+static inline uint32_t readFlashDword(const uint32_t *address)
+{
+	uint32_t dword;
+	__asm__ ("lpm %A0, Z+" "\n\t" "lpm %B0, Z+" "\n\t" "lpm %C0, Z+" "\n\t" "lpm %D0, Z" : "=r" (dword), "+z" (address));
+	return dword;
+}
+#endif
+/**@}*/
+
+#endif /* PROGRAMMEMORY_H_ */
+
+
+//////////////////////////////////////////////////////////
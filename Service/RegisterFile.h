@@ -4,6 +4,25 @@
 
 #include "dataTypes.h"
 
+/**
+*\defgroup registers Registers
+*\ingroup Service
+*@{
+*/
+/**
+*@brief <h2>8 bit I/O register access.</h2>
+*\details
+*\arg On the target it dereferences the memory mapped address of the register.
+*\arg In the host build (HOST_SIM defined) the registers live in the simulated I/O memory,\n
+and every access advances the simulated clock, see Simulator/Sim.h.
+*/
+#ifdef HOST_SIM
+#include "../Simulator/Sim.h"
+#define IO_REG8(address)	(*Sim_io(address))
+#else
+#define IO_REG8(address)	(*((volatile uint8_t*)(address)))
+#endif
+
 /**@}*/
  /************************************************************* Interrupts registers ************************************************************/
  /**
@@ -11,6 +30,14 @@
  *\ingroup registers
  *@{
  */
+ /**
+ *@brief <h2>Status Register.</h2>
+ *\details
+*\arg	Bit 7 - I: Global Interrupt Enable, set by sei and cleared by cli and on the entry of an ISR.
+*\arg	Saving it before cli and writing it back restores the interrupt flag as the caller had it.
+ */
+#define SREG	IO_REG8(0x5F)
+
  /**
  *@brief <h2>General Interrupt Control Register.</h2>
  *\image html GICR.png
@@ -20,7 +47,7 @@
 *\arg	Bit 6 - INT0: External Interrupt Request 0 Enable
 *\arg	Bit 5 - INT2: External Interrupt Request 2 Enable
  */
-#define GICR	(*((volatile uint8_t*)0x5B))
+#define GICR	IO_REG8(0x5B)
 
 /**
  *@brief <h2>General Interrupt Flag Register.</h2>
@@ -31,12 +58,14 @@
 *\arg	Bit 6 - INTF0: External Interrupt Flag 0 
 *\arg	Bit 5 - INTF2: External Interrupt Flag 2 
  */
-#define GIFR	(*((volatile uint8_t*)0x5A))
+#define GIFR	IO_REG8(0x5A)
 /**
  *@brief <h2>MCU Control Register.</h2>
  *\image html MCUCR.png
   *\image latex MCUCR.png
  *\details
+*\arg	Bit 7 - SE: Sleep Enable
+*\arg	Bit 6, 5, 4 - SM2, SM1, SM0: Sleep Mode Select Bits 2, 1 and 0, all cleared for the idle mode.
 *\arg	Bit 3, 2 - ISC11, ISC10: Interrupt Sense Control 1 Bit 1 and Bit 0.
 |ISCx1  |ISCx0  | Description											   |
 |:----: |:----: | :--------------------------------------------------------:|
@@ -49,7 +78,7 @@
 *\note x may be 0 or 1.
 
  */
-#define MCUCR	(*((volatile uint8_t*)0x55))
+#define MCUCR	IO_REG8(0x55)
 
 /**
  *@brief <h2>MCU Control and Status Register.</h2>
@@ -62,7 +91,7 @@ ISC2   | Description
 0	   | The falling edge on INT2 activates the interrupt request.
 1	   | The rising edge on INT2 activates the interrupt request.
  */
-#define MCUCSR	(*((volatile uint8_t*)0x54))
+#define MCUCSR	IO_REG8(0x54)
 /**@}*/
  /************************************************************* Timers registers ************************************************************/
 /**
@@ -152,7 +181,7 @@ pin it is connected to.
 	control of the counting.
 
 */
-#define TCCR0	(*((volatile uint8_t*)0x53))
+#define TCCR0	IO_REG8(0x53)
 /**
 *@brief <h2>Timer/Counter Register</h2>
 *\image html TCNT0.png
@@ -164,7 +193,7 @@ pin it is connected to.
 	*- Modifying the counter (TCNT0) while the counter is running, introduces a risk of missing a compare match\n
 	   between TCNT0 and the OCR0 Register.
 */
-#define TCNT0	(*((volatile uint8_t*)0x52))
+#define TCNT0	IO_REG8(0x52)
 /**
 *@brief <h2>Output Compare Register</h2>
 *\image html OCR0.png
@@ -175,7 +204,7 @@ pin it is connected to.
 	*- A match can be used to generate an output compare interrupt, or to generate a waveform\n
 	 output on the OC0 pin.
 */
-#define OCR0	(*((volatile uint8_t*)0x5C))
+#define OCR0	IO_REG8(0x5C)
 /**@}*/
 
 
@@ -205,7 +234,7 @@ pin it is connected to.
 	the Timer/Counter0 Overflow interrupt is executed.
 	*- In phase correct PWM mode, this bit is set when Timer/Counter0 changes counting direction at \$00.
 */
-#define TIFR	(*((volatile uint8_t*)0x58))
+#define TIFR	IO_REG8(0x58)
 /**
 *@brief <h2>Timer/Counter Interrupt Mask Register</h2>
 *\image html TIMSK.png
@@ -222,7 +251,7 @@ pin it is connected to.
 	*- The corresponding interrupt is executed if an overflow in Timer/Counter0 occurs,\n 
 	i.e., when the TOV0 bit is set in the Timer/Counter Interrupt Flag Register - TIFR.
 */
-#define TIMSK	(*((volatile uint8_t*)0x59))
+#define TIMSK	IO_REG8(0x59)
 /**@}*/
 
 
@@ -7,12 +7,20 @@
 *\details This file contains all the data types definitions that needed in this project.
 *@{
 */
+#ifdef HOST_SIM
+/* long is 8 bytes on 64 bit hosts, so the exact width types are taken from the host compiler */
+#include <stdint.h>
+typedef int8_t				 sint8_t;	/**<This is define a memory size of 1 byte signed*/
+typedef int16_t				 sint16_t;	/**<This is define a memory size of 2 byte signed*/
+typedef int32_t				 sint32_t;	/**<This is define a memory size of 4 byte signed*/
+#else
 typedef unsigned char 		 uint8_t;	/**<This is define a memory size of 1 byte*/
 typedef signed char 		 sint8_t;	/**<This is define a memory size of 1 byte signed*/
 typedef unsigned short int 	 uint16_t;	/**<This is define a memory size of 2 byte*/
 typedef signed short int 	 sint16_t;	/**<This is define a memory size of 2 byte signed*/
 typedef unsigned long int	 uint32_t;	/**<This is define a memory size of 4 byte*/
 typedef signed long int		 sint32_t;	/**<This is define a memory size of 4 byte signed*/
+#endif
 typedef float				 float32_t;	/**<This is define a memory size of 4 byte float*/
 typedef double				 float64_t;	/**<This is define a memory size of 8 byte float*/
 typedef long double			 float128_t;/**<This is define a memory size of 16 byte float*/
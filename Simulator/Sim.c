@@ -0,0 +1,317 @@
+//############# Sim.c ##############
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Sim.h"
+
+//memory mapped addresses and bits of the simulated registers, accessed here without advancing the clock
+#define SIM_IO_SIZE		0x60
+#define SIM_PINA		0x39
+#define SIM_MCUCR		0x55
+#define SIM_TCNT0		0x52
+#define SIM_TCCR0		0x53
+#define SIM_TIFR		0x58
+#define SIM_TIMSK		0x59
+#define SIM_GIFR		0x5A
+#define SIM_GICR		0x5B
+#define SIM_OCR0		0x5C
+//the global interrupt flag is the I bit of SREG, so a saved SREG written back restores it
+#define SIM_SREG		0x5F
+#define SIM_I_BIT		7
+#define SIM_NUM_OF_PORTS	4
+//the registers of port x are PINx, DDRx = PINx+1 and PORTx = PINx+2, port A is the highest
+#define SIM_PIN(port)	(SIM_PINA - 3*(port))
+#define SIM_DDR(port)	(SIM_PIN(port) + 1)
+#define SIM_PORT(port)	(SIM_PIN(port) + 2)
+//INT0 is PD2
+#define SIM_INT0_PORT	3
+#define SIM_INT0_PIN	2
+
+//ATmega32 interrupt vectors, an ISR the program doesn't define is left null
+extern void __vector_1(void) __attribute__((weak));
+extern void __vector_10(void) __attribute__((weak));
+extern void __vector_11(void) __attribute__((weak));
+
+typedef struct
+{
+	uint8_t port1;
+	uint8_t pin1;
+	uint8_t port2;
+	uint8_t pin2;
+}ST_Sim_wire_t;
+
+uint32_t Sim_systemClock = 8000000UL;
+
+static uint8_t Sim_globalIo[SIM_IO_SIZE];
+static uint64_t Sim_globalCycles = 0;
+static uint64_t Sim_globalCycleLimit = 0;
+//cycles spent in Sim_sleep with the sleep enable bit set
+static uint64_t Sim_globalSleepCycles = 0;
+//set when Sim_sei served an interrupt and nothing ran since, the sleep right after SEI wakes at once
+static uint8_t Sim_globalSeiServed = 0;
+//counter value as last written by the timer, a different value in TCNT0 means the program wrote it
+static uint8_t Sim_globalTcnt = 0;
+static ST_Sim_wire_t Sim_globalWires[SIM_MAX_WIRES];
+static uint8_t Sim_globalNumOfWires = 0;
+//pins pulled low from outside the MCU
+static uint8_t Sim_globalExternalLow[SIM_NUM_OF_PORTS];
+//traced pin
+static uint8_t Sim_globalTracePort = 0;
+static uint8_t Sim_globalTracePin = 0;
+static void (*Sim_globalTraceCallback)(uint8_t level, uint64_t cycle) = 0;
+
+static uint8_t Sim_portIndex(uint8_t port)
+{
+	return (uint8_t)(port - 'A') & (SIM_NUM_OF_PORTS-1);
+}
+
+//levels the pins of a port put on their wires, an output drives its PORT bit and an input is pulled up
+static uint8_t Sim_portDrive(uint8_t port)
+{
+	uint8_t ddr = Sim_globalIo[SIM_DDR(port)];
+	return ((Sim_globalIo[SIM_PORT(port)] & ddr) | ~ddr) & ~Sim_globalExternalLow[port];
+}
+
+static void Sim_updatePins(void)
+{
+	uint8_t pins[SIM_NUM_OF_PORTS];
+	for(uint8_t port = 0; port < SIM_NUM_OF_PORTS; port++)
+	{
+		pins[port] = Sim_portDrive(port);
+	}
+	//both ends of a wire see the wired-AND of their drives
+	for(uint8_t i = 0; i < Sim_globalNumOfWires; i++)
+	{
+		ST_Sim_wire_t *wire = &Sim_globalWires[i];
+		uint8_t level = ((Sim_portDrive(wire->port1)>>wire->pin1) & (Sim_portDrive(wire->port2)>>wire->pin2)) & 0x01;
+		pins[wire->port1] = (pins[wire->port1] & ~(1<<wire->pin1)) | (level<<wire->pin1);
+		pins[wire->port2] = (pins[wire->port2] & ~(1<<wire->pin2)) | (level<<wire->pin2);
+	}
+	//INT0 edge detection with the sense selected by ISC01:0
+	uint8_t oldInt0 = (Sim_globalIo[SIM_PIN(SIM_INT0_PORT)]>>SIM_INT0_PIN) & 0x01;
+	uint8_t newInt0 = (pins[SIM_INT0_PORT]>>SIM_INT0_PIN) & 0x01;
+	uint8_t sense = Sim_globalIo[SIM_MCUCR] & 0x03;
+	if((sense == 1 && oldInt0 != newInt0) || (sense == 2 && oldInt0 && !newInt0) || (sense == 3 && !oldInt0 && newInt0))
+	{
+		Sim_globalIo[SIM_GIFR] |= 1<<6;
+	}
+	if(Sim_globalTraceCallback)
+	{
+		uint8_t oldLevel = (Sim_globalIo[SIM_PIN(Sim_globalTracePort)]>>Sim_globalTracePin) & 0x01;
+		uint8_t newLevel = (pins[Sim_globalTracePort]>>Sim_globalTracePin) & 0x01;
+		if(oldLevel != newLevel)
+		{
+			Sim_globalTraceCallback(newLevel, Sim_globalCycles);
+		}
+	}
+	for(uint8_t port = 0; port < SIM_NUM_OF_PORTS; port++)
+	{
+		Sim_globalIo[SIM_PIN(port)] = pins[port];
+	}
+}
+
+static void Sim_timer0Tick(void)
+{
+	static const uint16_t prescaler[] = {0,1,8,64,256,1024,0,0};
+	uint8_t tccr0 = Sim_globalIo[SIM_TCCR0];
+	uint16_t division = prescaler[tccr0 & 0x07];
+	if(Sim_globalIo[SIM_TCNT0] != Sim_globalTcnt)
+	{
+		Sim_globalTcnt = Sim_globalIo[SIM_TCNT0];
+	}
+	//the counter is stopped, or clocked from T0 which isn't simulated
+	if(division == 0 || Sim_globalCycles % division != 0)
+	{
+		return;
+	}
+	uint8_t ocr0 = Sim_globalIo[SIM_OCR0];
+	//CTC mode clears the counter on the tick after the match
+	if((tccr0 & 0x48) == 0x40 && Sim_globalTcnt == ocr0)
+	{
+		Sim_globalTcnt = 0;
+	}
+	else
+	{
+		Sim_globalTcnt++;
+		if(Sim_globalTcnt == 0)
+		{
+			Sim_globalIo[SIM_TIFR] |= 1<<0;
+		}
+	}
+	if(Sim_globalTcnt == ocr0)
+	{
+		Sim_globalIo[SIM_TIFR] |= 1<<1;
+	}
+	Sim_globalIo[SIM_TCNT0] = Sim_globalTcnt;
+}
+
+static void Sim_step(uint32_t cycles)
+{
+	while(cycles--)
+	{
+		Sim_globalCycles++;
+		Sim_globalSeiServed = 0;
+		Sim_updatePins();
+		Sim_timer0Tick();
+		if(Sim_globalCycleLimit != 0 && Sim_globalCycles >= Sim_globalCycleLimit)
+		{
+			fprintf(stderr, "Sim: cycle limit %llu reached\n", (unsigned long long)Sim_globalCycleLimit);
+			exit(2);
+		}
+	}
+}
+
+static void Sim_callIsr(void (*isr)(void))
+{
+	Sim_globalIo[SIM_SREG] &= ~(1<<SIM_I_BIT);
+	Sim_step(SIM_ISR_ENTRY_CYCLES);
+	if(isr)
+	{
+		isr();
+	}
+	Sim_step(SIM_ISR_EXIT_CYCLES);
+	Sim_globalIo[SIM_SREG] |= 1<<SIM_I_BIT;
+}
+
+//serves the pending interrupt with the highest priority, returns 1 if one was served
+static uint8_t Sim_serveInterrupts(void)
+{
+	uint8_t served = 1;
+	if(!(Sim_globalIo[SIM_SREG] & (1<<SIM_I_BIT)))
+	{
+		served = 0;
+	}
+	else if((Sim_globalIo[SIM_GIFR] & Sim_globalIo[SIM_GICR]) & (1<<6))
+	{
+		Sim_globalIo[SIM_GIFR] &= ~(1<<6);
+		Sim_callIsr(__vector_1);
+	}
+	else if((Sim_globalIo[SIM_TIFR] & Sim_globalIo[SIM_TIMSK]) & (1<<1))
+	{
+		Sim_globalIo[SIM_TIFR] &= ~(1<<1);
+		Sim_callIsr(__vector_10);
+	}
+	else if((Sim_globalIo[SIM_TIFR] & Sim_globalIo[SIM_TIMSK]) & (1<<0))
+	{
+		Sim_globalIo[SIM_TIFR] &= ~(1<<0);
+		Sim_callIsr(__vector_11);
+	}
+	else
+	{
+		served = 0;
+	}
+	return served;
+}
+
+volatile uint8_t *Sim_io(uint8_t address)
+{
+	Sim_step(SIM_IO_CYCLES);
+	Sim_serveInterrupts();
+	return &Sim_globalIo[address];
+}
+
+void Sim_reset(void)
+{
+	memset(Sim_globalIo, 0, sizeof(Sim_globalIo));
+	memset(Sim_globalExternalLow, 0, sizeof(Sim_globalExternalLow));
+	Sim_globalCycles = 0;
+	Sim_globalCycleLimit = 0;
+	Sim_globalSleepCycles = 0;
+	Sim_globalSeiServed = 0;
+	Sim_globalTcnt = 0;
+	Sim_globalNumOfWires = 0;
+	Sim_globalTraceCallback = 0;
+	Sim_updatePins();
+}
+
+void Sim_sei(void)
+{
+	Sim_globalIo[SIM_SREG] |= 1<<SIM_I_BIT;
+	//a pending interrupt is served right after sei, not at the next register access
+	Sim_globalSeiServed = Sim_serveInterrupts();
+}
+
+void Sim_cli(void)
+{
+	Sim_globalIo[SIM_SREG] &= ~(1<<SIM_I_BIT);
+}
+
+void Sim_sleep(void)
+{
+	//on the target the interrupt served by SEI comes after the sleep instruction and wakes the CPU at once
+	if(!Sim_globalSeiServed)
+	{
+		//without the sleep enable bit the CPU runs the wait loop until the interrupt, the same time but awake
+		uint8_t asleep = (Sim_globalIo[SIM_MCUCR] & (1<<7)) != 0;
+		do
+		{
+			Sim_step(1);
+			Sim_globalSleepCycles += asleep;
+		}while(!Sim_serveInterrupts());
+	}
+	Sim_globalSeiServed = 0;
+}
+
+void Sim_run(uint32_t cycles)
+{
+	while(cycles--)
+	{
+		Sim_step(1);
+		Sim_serveInterrupts();
+	}
+}
+
+uint64_t Sim_cycles(void)
+{
+	return Sim_globalCycles;
+}
+
+uint64_t Sim_sleepCycles(void)
+{
+	return Sim_globalSleepCycles;
+}
+
+void Sim_setCycleLimit(uint64_t cycles)
+{
+	Sim_globalCycleLimit = cycles;
+}
+
+void Sim_wire(uint8_t port1, uint8_t pin1, uint8_t port2, uint8_t pin2)
+{
+	if(Sim_globalNumOfWires < SIM_MAX_WIRES)
+	{
+		ST_Sim_wire_t *wire = &Sim_globalWires[Sim_globalNumOfWires++];
+		wire->port1 = Sim_portIndex(port1);
+		wire->pin1 = pin1 & 0x07;
+		wire->port2 = Sim_portIndex(port2);
+		wire->pin2 = pin2 & 0x07;
+	}
+}
+
+void Sim_drive(uint8_t port, uint8_t pin, uint8_t level)
+{
+	port = Sim_portIndex(port);
+	if(level)
+	{
+		Sim_globalExternalLow[port] &= ~(1<<(pin & 0x07));
+	}
+	else
+	{
+		Sim_globalExternalLow[port] |= 1<<(pin & 0x07);
+	}
+}
+
+uint8_t Sim_pinLevel(uint8_t port, uint8_t pin)
+{
+	return (Sim_globalIo[SIM_PIN(Sim_portIndex(port))]>>(pin & 0x07)) & 0x01;
+}
+
+void Sim_trace(uint8_t port, uint8_t pin, void (*callback)(uint8_t level, uint64_t cycle))
+{
+	Sim_globalTracePort = Sim_portIndex(port);
+	Sim_globalTracePin = pin & 0x07;
+	Sim_globalTraceCallback = callback;
+}
+
+
+//////////////////////////////////////////////////////////
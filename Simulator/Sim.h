@@ -0,0 +1,150 @@
+//############# Sim.h ##############
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+
+/**
+*\defgroup simulator Host simulator
+*\details
+*\arg This is a host model of the ATmega32 parts used by the drivers, so they build and run on Linux.
+*\arg The I/O registers live in a simulated memory, every access through #IO_REG8 advances a virtual cycle clock.
+*\arg On every cycle Timer 0 counts from #TCCR0, #TCNT0 and #OCR0, the port pins are updated from the DDR and PORT
+registers and the wires between them, and the pending interrupts of #EXT_INT0, #TIM0_COMP and #TIM0_OVF are served
+by calling their ISR functions.
+*\arg The CPU itself is not simulated, the C code costs only #SIM_IO_CYCLES per register access and
+#SIM_ISR_ENTRY_CYCLES, #SIM_ISR_EXIT_CYCLES per interrupt, which is enough to time the pins in cycles.
+*\arg Writing 1 to clear a flag in #TIFR or #GIFR is not modeled, the flags are cleared when their ISR is called.
+*\arg Build the drivers with HOST_SIM defined, for example:
+\code
+gcc -DHOST_SIM -DSYSTEM_CLK=8000000UL -I"MCAL/DIO" -I"MCAL/Timer driver" -I"MCAL/Software UART" \
+	Simulator/Sim.c Simulator/loopback.c MCAL/DIO/Dio.c "MCAL/Timer driver/Timer_0.c" \
+	"MCAL/Timer driver/TimerService.c" "MCAL/Software UART/SWUART.c" -o loopback
+\endcode
+*@{
+*/
+
+/**
+*@brief Cycles taken by one register access.
+*/
+#ifndef SIM_IO_CYCLES
+#define SIM_IO_CYCLES			2
+#endif
+/**
+*@brief Cycles from the interrupt request to the first instruction of the ISR body, including the prologue.
+*/
+#ifndef SIM_ISR_ENTRY_CYCLES
+#define SIM_ISR_ENTRY_CYCLES	10
+#endif
+/**
+*@brief Cycles of the ISR epilogue and reti.
+*/
+#ifndef SIM_ISR_EXIT_CYCLES
+#define SIM_ISR_EXIT_CYCLES		10
+#endif
+/**
+*@brief Number of wires that can be connected between the pins.
+*/
+#define SIM_MAX_WIRES			8
+
+/**
+*@brief <h3>Run time system clock</h3>
+*@details
+*\arg Building with -DSYSTEM_CLK=Sim_systemClock makes the drivers read the clock from this variable,
+so one host program can run them at several clocks.
+*/
+extern uint32_t Sim_systemClock;
+/**
+*@brief <h3>Register access</h3>
+*@details
+*\arg This function advances the clock by #SIM_IO_CYCLES, serves the pending interrupts and returns the register.
+*@param[in] address Memory mapped address of the register, as on the target.
+*@retval pointer to the register in the simulated I/O memory.
+*/
+volatile uint8_t *Sim_io(uint8_t address);
+/**
+*@brief <h3>Simulator reset</h3>
+*@details
+*\arg This function clears the registers, the wires, the clock and the global interrupt flag.
+*/
+void Sim_reset(void);
+/**
+*@brief Sets the global interrupt flag.
+*/
+void Sim_sei(void);
+/**
+*@brief Clears the global interrupt flag.
+*/
+void Sim_cli(void);
+/**
+*@brief <h3>CPU sleep</h3>
+*@details
+*\arg This function advances the clock until an interrupt is served, as the code is waiting for it anyway.
+*\arg With the sleep enable bit of #MCUCR set the cycles are counted as asleep by #Sim_sleepCycles,
+without it the CPU spins in the wait loop for the same time.
+*\arg Right after a #Sim_sei that served an interrupt it returns at once, as the target wakes from a sleep
+instruction that follows SEI with an interrupt pending.
+*/
+void Sim_sleep(void);
+/**
+*@brief <h3>Run</h3>
+*@details
+*\arg This function advances the clock while the main code does nothing, serving the interrupts.
+*@param[in] cycles Number of cycles to run.
+*/
+void Sim_run(uint32_t cycles);
+/**
+*@brief Returns the number of cycles since #Sim_reset.
+*/
+uint64_t Sim_cycles(void);
+/**
+*@brief Returns the number of cycles the CPU slept since #Sim_reset, the other cycles it was awake.
+*/
+uint64_t Sim_sleepCycles(void);
+/**
+*@brief <h3>Cycle limit</h3>
+*@details
+*\arg The simulation stops with an error message when the clock reaches the limit, so a waiting code can't hang the host.
+*@param[in] cycles Limit in cycles since #Sim_reset, 0 means no limit.
+*/
+void Sim_setCycleLimit(uint64_t cycles);
+/**
+*@brief <h3>Wire</h3>
+*@details
+*\arg This function connects two pins by a wire, both pins see the wired-AND of all the outputs driving it,
+a wire or an input that nobody drives low is pulled up.
+*@param[in] port1 Port character of the first pin, 'A', 'B', ... etc.
+*@param[in] pin1 Pin number of the first pin.
+*@param[in] port2 Port character of the second pin.
+*@param[in] pin2 Pin number of the second pin.
+*/
+void Sim_wire(uint8_t port1, uint8_t pin1, uint8_t port2, uint8_t pin2);
+/**
+*@brief <h3>External drive</h3>
+*@details
+*\arg This function drives a pin, and its wire if it has one, from outside the MCU like a peer device.
+*@param[in] port Port character of the pin.
+*@param[in] pin Pin number.
+*@param[in] level LOW drives the pin low, HIGH releases it.
+*/
+void Sim_drive(uint8_t port, uint8_t pin, uint8_t level);
+/**
+*@brief Returns the level of a pin as the MCU reads it, 0 or 1.
+*/
+uint8_t Sim_pinLevel(uint8_t port, uint8_t pin);
+/**
+*@brief <h3>Trace</h3>
+*@details
+*\arg This function watches one pin, the callback is called with the new level and the cycle of every change.
+*@param[in] port Port character of the pin.
+*@param[in] pin Pin number.
+*@param[in] callback Function called on every change, null stops the trace.
+*/
+void Sim_trace(uint8_t port, uint8_t pin, void (*callback)(uint8_t level, uint64_t cycle));
+/**@}*/
+
+#endif /* SIM_H_ */
+
+
+//////////////////////////////////////////////////////////
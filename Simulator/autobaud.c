@@ -0,0 +1,180 @@
+//############# autobaud.c ##############
+/*
+ * Auto-baud run of the SW UART driver on the simulator.
+ * A peer driven with Sim_drive on the RX pin of the default channel sends a byte that isn't the sync byte,
+ * then SWUART_SYNC_BYTE and two data bytes back to back, in the frame format of the driver, while the main code
+ * polls SWUART_autoBaudDone once a bit. Every run is made with and without a break before the first byte.
+ * Build it like the loopback run in Sim.h with Simulator/autobaud.c instead of Simulator/loopback.c,
+ * -DSYSTEM_CLK=Sim_systemClock.
+ *
+ * The runs cover the clocks and the baudrates of the benchmark up to its highest reliable baudrate,
+ * with the peer at the baudrate and 2% slower and faster.
+ * The detected baudrate must be within AUTOBAUD_TOLERANCE of the peer and both data bytes must be received,
+ * their bits above SWUART_DATA_BITS aren't sent.
+ * At 1 MHz the data bytes are checked only up to 4800 baud: at 9600 baud the tick takes almost all the cycles
+ * and the receiver loses bytes of a peer at some phases of its bits, with or without auto-baud.
+ * For every run one line is printed with the detected baudrate and the bytes received.
+ * It returns 0 if every run detected the baudrate and received the data bytes.
+ */
+#include <stdio.h>
+#include "SWUART.h"
+#include "Sim.h"
+
+//the detected baudrate may be this fraction of the baudrate of the peer off it
+#define AUTOBAUD_TOLERANCE		100
+//a break is this many bit times low
+#define AUTOBAUD_BREAK_BITS		13
+#define AUTOBAUD_FIRST_BYTE		0x12
+
+typedef struct
+{
+	uint32_t clock;
+	uint32_t highest;		/* highest reliable baudrate of the benchmark at the prescaler SWUART_init selects */
+	uint32_t highestData;	/* highest baudrate the data bytes are checked at */
+}ST_Autobaud_clock_t;
+
+static const ST_Autobaud_clock_t Autobaud_clocks[] =
+{
+	{1000000UL, 9600, 4800},
+	{8000000UL, 57600, 57600},
+	{16000000UL, 115200, 115200}
+};
+static const uint32_t Autobaud_baudrates[] = {1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200};
+//the baudrate of the peer in percent of the nominal baudrate
+static const uint8_t Autobaud_skews[] = {98, 100, 102};
+static const SWUART_data_t Autobaud_data[] = {0xA7, 0x3C};
+
+static uint64_t Autobaud_globalBitEnd = 0;
+static uint32_t Autobaud_globalBitCycles = 0;
+static En_SWUART_Error_t Autobaud_globalResult = SWUART_AUTOBAUD_PENDING;
+static uint32_t Autobaud_globalBaudrate = 0;
+
+//drives one bit time of the peer, the bits are timed on the clock as Sim_run doesn't count the cycles of the ISRs
+static void Autobaud_bit(uint8_t level)
+{
+	Sim_drive(UART_RX_PORT, RX, level);
+	Autobaud_globalBitEnd += Autobaud_globalBitCycles;
+	while(Sim_cycles() < Autobaud_globalBitEnd)
+	{
+		Sim_run(1);
+	}
+	if(Autobaud_globalResult == SWUART_AUTOBAUD_PENDING)
+	{
+		Autobaud_globalResult = SWUART_autoBaudDone(&Autobaud_globalBaudrate);
+	}
+}
+
+static void Autobaud_frame(SWUART_data_t data)
+{
+	uint8_t ones = 0;
+	Autobaud_bit(LOW);
+	for(uint8_t i = 0; i < SWUART_DATA_BITS; i++)
+	{
+#if SWUART_BIT_ORDER == SWUART_MSB_FIRST
+		uint8_t level = (data >> (SWUART_DATA_BITS-1-i)) & 0x01;
+#else
+		uint8_t level = (data >> i) & 0x01;
+#endif
+		ones += level;
+		Autobaud_bit(level);
+	}
+#if SWUART_PARITY == SWUART_PARITY_EVEN
+	Autobaud_bit(ones & 0x01);
+#elif SWUART_PARITY == SWUART_PARITY_ODD
+	Autobaud_bit(!(ones & 0x01));
+#elif SWUART_PARITY == SWUART_PARITY_MARK
+	Autobaud_bit(HIGH);
+#elif SWUART_PARITY == SWUART_PARITY_SPACE
+	Autobaud_bit(LOW);
+#endif
+	(void)ones;
+	for(uint8_t i = 1+SWUART_DATA_BITS+SWUART_PARITY_BITS; i < SWUART_FRAME_BITS; i++)
+	{
+		Autobaud_bit(HIGH);
+	}
+}
+
+//returns 1 if the run failed
+static uint8_t Autobaud_run(const ST_Autobaud_clock_t *clock, uint32_t baudrate, uint8_t skew, uint8_t withBreak)
+{
+	//the bit time of the peer is whole cycles, its baudrate is counted from them
+	uint32_t bitCycles = clock->clock*(uint64_t)100/(baudrate*skew);
+	uint32_t peer = clock->clock/bitCycles;
+	SWUART_data_t received[sizeof(Autobaud_data)/sizeof(Autobaud_data[0])];
+	uint8_t numOfReceived = 0;
+
+	Sim_reset();
+	Sim_systemClock = clock->clock;
+	Sim_setCycleLimit(10*(uint64_t)clock->clock);
+	Autobaud_globalBitCycles = bitCycles;
+	Autobaud_globalResult = SWUART_AUTOBAUD_PENDING;
+	Autobaud_globalBaudrate = 0;
+	SWUART_autoBaudStart();
+	Sim_run(1000);
+	Autobaud_globalBitEnd = Sim_cycles();
+	if(withBreak)
+	{
+		for(uint8_t i = 0; i < AUTOBAUD_BREAK_BITS; i++)
+		{
+			Autobaud_bit(LOW);
+		}
+		Autobaud_bit(HIGH);
+	}
+	Autobaud_frame(AUTOBAUD_FIRST_BYTE);
+	Autobaud_frame(SWUART_SYNC_BYTE);
+	for(uint8_t i = 0; i < sizeof(Autobaud_data)/sizeof(Autobaud_data[0]); i++)
+	{
+		Autobaud_frame(Autobaud_data[i]);
+	}
+	Sim_run(SWUART_FRAME_BITS*Autobaud_globalBitCycles);
+
+	uint8_t numOfAvailable = SWUART_available();
+	while(numOfReceived < sizeof(received)/sizeof(received[0]) && SWUART_tryReceive(&received[numOfReceived]) == SWUART_OK)
+	{
+		numOfReceived++;
+	}
+	uint32_t error = Autobaud_globalBaudrate > peer ? Autobaud_globalBaudrate - peer : peer - Autobaud_globalBaudrate;
+	uint8_t failed = Autobaud_globalResult != SWUART_OK || error > peer/AUTOBAUD_TOLERANCE;
+	uint8_t checkData = baudrate <= clock->highestData;
+	if(checkData)
+	{
+		failed |= numOfAvailable != sizeof(received)/sizeof(received[0]);
+		for(uint8_t i = 0; i < numOfReceived; i++)
+		{
+			failed |= received[i] != (Autobaud_data[i] & SWUART_DATA_MASK);
+		}
+	}
+	printf("clk %lu peer %lu%s: detected %lu, received", (unsigned long)clock->clock, (unsigned long)peer,
+		withBreak ? " after a break" : "", (unsigned long)Autobaud_globalBaudrate);
+	for(uint8_t i = 0; i < numOfReceived; i++)
+	{
+		printf(" %02X", (unsigned)received[i]);
+	}
+	printf("%s%s\n", checkData ? "" : " (not checked)", failed ? ", wrong" : "");
+	return failed;
+}
+
+int main(void)
+{
+	uint16_t failed = 0;
+	for(uint8_t c = 0; c < sizeof(Autobaud_clocks)/sizeof(Autobaud_clocks[0]); c++)
+	{
+		for(uint8_t b = 0; b < sizeof(Autobaud_baudrates)/sizeof(Autobaud_baudrates[0]); b++)
+		{
+			if(Autobaud_baudrates[b] > Autobaud_clocks[c].highest)
+			{
+				continue;
+			}
+			for(uint8_t s = 0; s < sizeof(Autobaud_skews); s++)
+			{
+				failed += Autobaud_run(&Autobaud_clocks[c], Autobaud_baudrates[b], Autobaud_skews[s], 0);
+				failed += Autobaud_run(&Autobaud_clocks[c], Autobaud_baudrates[b], Autobaud_skews[s], 1);
+			}
+		}
+	}
+	printf("failed runs %u\n", failed);
+	return failed != 0;
+}
+
+
+//////////////////////////////////////////////////////////
@@ -0,0 +1,239 @@
+//############# benchmark.c ##############
+/*
+ * Baud accuracy and jitter benchmark of the SW UART driver on the simulator.
+ * It sweeps SYSTEM_CLK, the Timer 0 clock source and the baudrate, sends back to back frames in loopback
+ * and measures the TX pin edges against the ideal bit grid.
+ * Build it like the loopback run in Sim.h with Simulator/benchmark.c instead of Simulator/loopback.c,
+ * -DSYSTEM_CLK=Sim_systemClock and -lm.
+ *
+ * For every configuration one CSV line is printed:
+ *   clk_hz        system clock
+ *   prescaler     Timer 0 prescaler, 0 is the one SWUART_init selects
+ *   baud          requested baudrate
+ *   bit_err_pct   mean bit period error, from the least squares fit of all the edges
+ *   jitter_cyc    worst edge distance from the fitted bit grid in cycles
+ *   jitter_pct    the same in percent of the ideal bit time
+ *   frame_err_pct mean frame length error between consecutive start edges
+ *   wire_util_pct frames sent in the time from the first to the last start edge, in percent of the frames
+ *                 the line could carry at the ideal bit time back to back
+ *   max_dev_pct   worst edge distance from the ideal grid started at its own start edge, in percent of a bit
+ *   loopback      1 if all the frames were received back unchanged
+ *   reliable      1 if loopback is 1 and max_dev_pct is within BENCH_MAX_DEVIATION_PCT
+ *   awake_pct     the frames are sent again with SWUART_sendBuffer and waited with SWUART_receiveBuffer,
+ *                 the cycles the CPU was awake until it returned in percent, the rest it slept in the driver waits
+ *   awake_cyc     the same awake cycles per byte transferred
+ * followed by a table of the highest reliable baudrate for every clock and prescaler.
+ */
+#include <stdio.h>
+#include <math.h>
+#include "SWUART.h"
+#include "Sim.h"
+
+//the peer samples in the middle of the bit, so a quarter bit is left for its own clock error and sampling
+#define BENCH_MAX_DEVIATION_PCT	25.0
+#define BENCH_NUM_OF_FRAMES		8
+#define BENCH_MAX_EDGES			(BENCH_NUM_OF_FRAMES*SWUART_FRAME_BITS)
+//ideal frame length in bits, the half stop bit counts as half
+#if SWUART_STOP_BITS == SWUART_STOP_BITS_1_5
+#define BENCH_FRAME_LENGTH		(SWUART_FRAME_BITS-0.5)
+#else
+#define BENCH_FRAME_LENGTH		SWUART_FRAME_BITS
+#endif
+
+static const uint32_t Bench_clocks[] = {1000000UL, 8000000UL, 16000000UL};
+static const uint32_t Bench_baudrates[] = {1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200};
+static const uint16_t Bench_prescalers[] = {0, 1, 8, 64, 256, 1024};
+static const SWUART_data_t Bench_data[BENCH_NUM_OF_FRAMES] = {0x55, 0xAA, 0x00, 0xFF, 0x0F, 0xF0, 0x33, 0xC3};
+
+static uint64_t Bench_edgeCycles[BENCH_MAX_EDGES+1];
+static uint16_t Bench_numOfEdges = 0;
+
+static void Bench_edge(uint8_t level, uint64_t cycle)
+{
+	(void)level;
+	if(Bench_numOfEdges <= BENCH_MAX_EDGES)
+	{
+		Bench_edgeCycles[Bench_numOfEdges++] = cycle;
+	}
+}
+
+//bit positions of the expected edges of the frames and their frames, counted from the first start edge
+static uint16_t Bench_expectedEdges(double *bitIndex, uint8_t *edgeFrame, uint16_t *frameStart)
+{
+	uint16_t numOfEdges = 0;
+	uint8_t level = 1;
+	for(uint8_t frame = 0; frame < BENCH_NUM_OF_FRAMES; frame++)
+	{
+		uint8_t bits[SWUART_FRAME_BITS];
+		uint8_t parity = 0;
+		bits[0] = 0;
+		for(uint8_t i = 0; i < SWUART_DATA_BITS; i++)
+		{
+#if SWUART_BIT_ORDER == SWUART_LSB_FIRST
+			bits[i+1] = (Bench_data[frame]>>i) & 0x01;
+#else
+			bits[i+1] = (Bench_data[frame]>>(SWUART_DATA_BITS-1-i)) & 0x01;
+#endif
+			parity ^= bits[i+1];
+		}
+#if SWUART_PARITY == SWUART_PARITY_EVEN
+		bits[SWUART_DATA_BITS+1] = parity;
+#elif SWUART_PARITY == SWUART_PARITY_ODD
+		bits[SWUART_DATA_BITS+1] = !parity;
+#elif SWUART_PARITY == SWUART_PARITY_MARK
+		bits[SWUART_DATA_BITS+1] = 1;
+#elif SWUART_PARITY == SWUART_PARITY_SPACE
+		bits[SWUART_DATA_BITS+1] = 0;
+#endif
+		(void)parity;
+		for(uint8_t i = SWUART_DATA_BITS+SWUART_PARITY_BITS+1; i < SWUART_FRAME_BITS; i++)
+		{
+			bits[i] = 1;
+		}
+		for(uint8_t i = 0; i < SWUART_FRAME_BITS; i++)
+		{
+			if(bits[i] != level)
+			{
+				if(i == 0)
+				{
+					frameStart[frame] = numOfEdges;
+				}
+				edgeFrame[numOfEdges] = frame;
+				bitIndex[numOfEdges++] = frame*BENCH_FRAME_LENGTH + i;
+				level = bits[i];
+			}
+		}
+	}
+	return numOfEdges;
+}
+
+static void Bench_run(uint32_t clock, uint16_t prescaler, uint32_t baudrate, uint32_t *highest)
+{
+	static const EN_Timer0_clkSource_t clkSources[] = {NO_CLOCK_SOURCE, clkI_No_DIVISON, clkI_DIVISION_BY_8,
+		clkI_DIVISION_BY_64, clkI_DIVISION_BY_256, clkI_DIVISION_BY_1024};
+	double bitIndex[BENCH_MAX_EDGES];
+	uint8_t edgeFrame[BENCH_MAX_EDGES];
+	uint16_t frameStart[BENCH_NUM_OF_FRAMES];
+	double bitCycles = (double)clock/baudrate;
+
+	Sim_reset();
+	Sim_systemClock = clock;
+	Sim_wire(UART_PORT, TX, UART_RX_PORT, RX);
+	SWUART_init(baudrate);
+	if(prescaler != 0)
+	{
+		uint8_t i = 0;
+		while(Bench_prescalers[i] != prescaler)
+		{
+			i++;
+		}
+		if(Timer0_initPeriodic(clkSources[i], baudrate*SWUART_TICKS_PER_BIT) != TIMER0_OK)
+		{
+			//the bit clock can't be generated with this prescaler
+			printf("%lu,%u,%lu,nan,nan,nan,nan,nan,nan,0,0,nan,nan\n", (unsigned long)clock, prescaler, (unsigned long)baudrate);
+			return;
+		}
+	}
+	//let the line settle before tracing
+	Sim_run(SWUART_TICKS_PER_BIT*(uint32_t)bitCycles);
+	Bench_numOfEdges = 0;
+	Sim_trace(UART_PORT, TX, Bench_edge);
+	SWUART_sendBuffer(Bench_data, BENCH_NUM_OF_FRAMES);
+	Sim_run((uint32_t)(bitCycles*SWUART_FRAME_BITS*(BENCH_NUM_OF_FRAMES+2)));
+
+	uint8_t loopback = SWUART_available() == BENCH_NUM_OF_FRAMES;
+	for(uint8_t i = 0; i < BENCH_NUM_OF_FRAMES; i++)
+	{
+		loopback &= SWUART_read() == (Bench_data[i] & SWUART_DATA_MASK);
+	}
+	while(SWUART_available() != 0)
+	{
+		SWUART_read();
+	}
+
+	//the same frames waited in the driver, with a timeout of twice their time in case they don't come back
+	SWUART_data_t received[BENCH_NUM_OF_FRAMES];
+	uint16_t timeout = (uint16_t)(2000.0*SWUART_FRAME_BITS*BENCH_NUM_OF_FRAMES/baudrate) + 1;
+	Sim_trace(UART_PORT, TX, 0);
+	uint64_t start = Sim_cycles();
+	uint64_t sleepStart = Sim_sleepCycles();
+	SWUART_sendBuffer(Bench_data, BENCH_NUM_OF_FRAMES);
+	SWUART_receiveBuffer(received, BENCH_NUM_OF_FRAMES, timeout);
+	uint64_t cycles = Sim_cycles() - start;
+	uint64_t awake = cycles - (Sim_sleepCycles() - sleepStart);
+
+	uint16_t numOfEdges = Bench_expectedEdges(bitIndex, edgeFrame, frameStart);
+	double bitErr = NAN, jitter = NAN, frameErr = NAN, wireUtil = NAN, maxDev = NAN;
+	if(Bench_numOfEdges == numOfEdges)
+	{
+		//least squares fit of the edge cycles over their bit indexes
+		double sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+		for(uint16_t i = 0; i < numOfEdges; i++)
+		{
+			double x = bitIndex[i];
+			double y = (double)(Bench_edgeCycles[i] - Bench_edgeCycles[0]);
+			sumX += x; sumY += y; sumXX += x*x; sumXY += x*y;
+		}
+		double slope = (numOfEdges*sumXY - sumX*sumY)/(numOfEdges*sumXX - sumX*sumX);
+		double offset = (sumY - slope*sumX)/numOfEdges;
+		bitErr = 100.0*(slope/bitCycles - 1.0);
+		jitter = 0;
+		maxDev = 0;
+		for(uint16_t i = 0; i < numOfEdges; i++)
+		{
+			double y = (double)(Bench_edgeCycles[i] - Bench_edgeCycles[0]);
+			jitter = fmax(jitter, fabs(y - offset - slope*bitIndex[i]));
+			//distance from the ideal grid of its own frame
+			uint16_t start = frameStart[edgeFrame[i]];
+			double fromStart = (double)(Bench_edgeCycles[i] - Bench_edgeCycles[start]);
+			maxDev = fmax(maxDev, fabs(fromStart - (bitIndex[i] - bitIndex[start])*bitCycles));
+		}
+		double frameCycles = (double)(Bench_edgeCycles[frameStart[BENCH_NUM_OF_FRAMES-1]] - Bench_edgeCycles[frameStart[0]])/(BENCH_NUM_OF_FRAMES-1);
+		frameErr = 100.0*(frameCycles/(bitCycles*BENCH_FRAME_LENGTH) - 1.0);
+		wireUtil = 100.0*bitCycles*BENCH_FRAME_LENGTH/frameCycles;
+		maxDev = 100.0*maxDev/bitCycles;
+	}
+	uint8_t reliable = loopback && maxDev <= BENCH_MAX_DEVIATION_PCT;
+	if(reliable && baudrate > *highest)
+	{
+		*highest = baudrate;
+	}
+	printf("%lu,%u,%lu,%.3f,%.1f,%.2f,%.3f,%.2f,%.2f,%u,%u,%.1f,%llu\n", (unsigned long)clock, prescaler, (unsigned long)baudrate,
+		bitErr, jitter, 100.0*jitter/bitCycles, frameErr, wireUtil, maxDev, loopback, reliable,
+		100.0*awake/cycles, (unsigned long long)(awake/BENCH_NUM_OF_FRAMES));
+}
+
+int main(void)
+{
+	uint32_t highest[sizeof(Bench_clocks)/sizeof(Bench_clocks[0])][sizeof(Bench_prescalers)/sizeof(Bench_prescalers[0])] = {{0}};
+	printf("clk_hz,prescaler,baud,bit_err_pct,jitter_cyc,jitter_pct,frame_err_pct,wire_util_pct,max_dev_pct,loopback,reliable,awake_pct,awake_cyc\n");
+	for(uint8_t c = 0; c < sizeof(Bench_clocks)/sizeof(Bench_clocks[0]); c++)
+	{
+		for(uint8_t p = 0; p < sizeof(Bench_prescalers)/sizeof(Bench_prescalers[0]); p++)
+		{
+			for(uint8_t b = 0; b < sizeof(Bench_baudrates)/sizeof(Bench_baudrates[0]); b++)
+			{
+				Bench_run(Bench_clocks[c], Bench_prescalers[p], Bench_baudrates[b], &highest[c][p]);
+			}
+		}
+	}
+	printf("\nhighest reliable baudrate (prescaler 0 = selected by SWUART_init)\n%10s", "clk_hz");
+	for(uint8_t p = 0; p < sizeof(Bench_prescalers)/sizeof(Bench_prescalers[0]); p++)
+	{
+		printf("%10u", Bench_prescalers[p]);
+	}
+	printf("\n");
+	for(uint8_t c = 0; c < sizeof(Bench_clocks)/sizeof(Bench_clocks[0]); c++)
+	{
+		printf("%10lu", (unsigned long)Bench_clocks[c]);
+		for(uint8_t p = 0; p < sizeof(Bench_prescalers)/sizeof(Bench_prescalers[0]); p++)
+		{
+			printf("%10lu", (unsigned long)highest[c][p]);
+		}
+		printf("\n");
+	}
+	return 0;
+}
+
+
+//////////////////////////////////////////////////////////
@@ -0,0 +1,223 @@
+//############# calibration.c ##############
+/*
+ * Clock calibration and tracking run of the SW UART driver on the simulator.
+ * A peer driven with Sim_drive on the RX pin of the default channel sends at a known baudrate in the frame format
+ * of the driver. A system clock that is off SYSTEM_CLK is simulated by the bit time of the peer, an MCU clock 2% slow
+ * counts 2% fewer cycles in a bit, so the driver must measure the clock as the cycles of a bit times the baudrate.
+ * Build it like the loopback run in Sim.h with Simulator/calibration.c instead of Simulator/loopback.c
+ * and -DSWUART_CLOCK_TRACKING=1.
+ *
+ * The cases are:
+ * the calibration with SWUART_calibrationStart and SWUART_calibrationDone polled once a bit, for clocks up to 5%
+ * off, then CALIBRATION_NUM_OF_BYTES bytes received at the calibrated clock,
+ * a clock out of SWUART_CLOCK_RANGE, which must not be taken,
+ * and the clock tracking on the normal traffic at several baudrates, which must give the clock within
+ * CALIBRATION_TRACK_TOLERANCE from SWUART_CLOCK_TRACK_FRAMES timed frames within CALIBRATION_TRACK_MAX_FRAMES frames,
+ * then CALIBRATION_NUM_OF_BYTES bytes received at the tracked clock.
+ * It returns 0 if every measured clock is within its tolerance and every byte after it is received.
+ */
+#include <stdio.h>
+#include "SWUART.h"
+#include "Timer_0.h"
+#include "Sim.h"
+
+#if !SWUART_CLOCK_TRACKING
+#error "the tracking cases need the clock tracking, build it with -DSWUART_CLOCK_TRACKING=1"
+#endif
+
+#define CALIBRATION_BAUDRATE		9600
+#define CALIBRATION_NUM_OF_BYTES	20
+#define CALIBRATION_FIRST_BYTE		0x12
+//the measured clock may be this fraction of the expected clock off it
+#define CALIBRATION_TOLERANCE		300
+#define CALIBRATION_TRACK_TOLERANCE	200
+//frames sent before the tracking must have given the clock
+#define CALIBRATION_TRACK_MAX_FRAMES	(4*SWUART_CLOCK_TRACK_FRAMES)
+//the clock out of SWUART_CLOCK_RANGE is 20% fast
+#define CALIBRATION_OUT_OF_RANGE	120
+
+//the clock of the MCU in per mille of SYSTEM_CLK
+static const uint16_t Calibration_clocks[] = {950, 980, 1000, 1020, 1050};
+static const struct
+{
+	uint32_t baudrate;
+	uint16_t clock;			/* the clock of the MCU in per mille of SYSTEM_CLK */
+}Calibration_tracks[] =
+{
+	{9600, 980}, {9600, 1020}, {38400, 1000}, {4800, 975}, {9600, 965}, {9600, 1035}
+};
+
+static uint64_t Calibration_globalBitEnd = 0;
+static uint32_t Calibration_globalBitCycles = 0;
+static En_SWUART_Error_t Calibration_globalResult = SWUART_AUTOBAUD_PENDING;
+static uint32_t Calibration_globalClock = 0;
+static uint16_t Calibration_globalErrors = 0;
+
+//drives one bit time of the peer, the bits are timed on the clock as Sim_run doesn't count the cycles of the ISRs
+static void Calibration_bit(uint8_t level)
+{
+	Sim_drive(UART_RX_PORT, RX, level);
+	Calibration_globalBitEnd += Calibration_globalBitCycles;
+	while(Sim_cycles() < Calibration_globalBitEnd)
+	{
+		Sim_run(1);
+	}
+	if(Calibration_globalResult == SWUART_AUTOBAUD_PENDING)
+	{
+		Calibration_globalResult = SWUART_calibrationDone(&Calibration_globalClock);
+	}
+}
+
+static void Calibration_frame(SWUART_data_t data)
+{
+	uint8_t ones = 0;
+	Calibration_bit(LOW);
+	for(uint8_t i = 0; i < SWUART_DATA_BITS; i++)
+	{
+#if SWUART_BIT_ORDER == SWUART_MSB_FIRST
+		uint8_t level = (data >> (SWUART_DATA_BITS-1-i)) & 0x01;
+#else
+		uint8_t level = (data >> i) & 0x01;
+#endif
+		ones += level;
+		Calibration_bit(level);
+	}
+#if SWUART_PARITY == SWUART_PARITY_EVEN
+	Calibration_bit(ones & 0x01);
+#elif SWUART_PARITY == SWUART_PARITY_ODD
+	Calibration_bit(!(ones & 0x01));
+#elif SWUART_PARITY == SWUART_PARITY_MARK
+	Calibration_bit(HIGH);
+#elif SWUART_PARITY == SWUART_PARITY_SPACE
+	Calibration_bit(LOW);
+#endif
+	(void)ones;
+	for(uint8_t i = 1+SWUART_DATA_BITS+SWUART_PARITY_BITS; i < SWUART_FRAME_BITS; i++)
+	{
+		Calibration_bit(HIGH);
+	}
+}
+
+//starts the peer with a bit time for the clock of the MCU in per mille of SYSTEM_CLK, returns the expected clock
+static uint32_t Calibration_peer(uint32_t baudrate, uint16_t clock)
+{
+	Calibration_globalBitCycles = (uint64_t)SYSTEM_CLK*clock/(1000*(uint64_t)baudrate);
+	Sim_run(1000);
+	Calibration_globalBitEnd = Sim_cycles();
+	Calibration_bit(HIGH);
+	Calibration_bit(HIGH);
+	//the bit time is whole cycles, the clock that gives it is counted from them
+	return Calibration_globalBitCycles*baudrate;
+}
+
+//sends bytes at the measured clock and returns the number received unchanged
+static uint8_t Calibration_bytes(SWUART_data_t first, SWUART_data_t step)
+{
+	uint8_t numOfReceived = 0;
+	SWUART_data_t data = first;
+	for(uint8_t i = 0; i < CALIBRATION_NUM_OF_BYTES; i++)
+	{
+		Calibration_frame(data & SWUART_DATA_MASK);
+		if(SWUART_available() != 0 && SWUART_read() == (data & SWUART_DATA_MASK))
+		{
+			numOfReceived++;
+		}
+		data += step;
+	}
+	return numOfReceived;
+}
+
+static void Calibration_check(const char *name, uint32_t baudrate, uint16_t clock, uint8_t good, uint32_t expected,
+	uint16_t tolerance, uint8_t numOfReceived)
+{
+	uint32_t error = Calibration_globalClock > expected ? Calibration_globalClock - expected : expected - Calibration_globalClock;
+	good &= error <= expected/tolerance && numOfReceived == CALIBRATION_NUM_OF_BYTES;
+	printf("%s: %lu baud, clock %u.%u%%, measured %lu, expected %lu, %u of %u bytes%s\n", name, (unsigned long)baudrate,
+		clock/10, clock%10, (unsigned long)Calibration_globalClock, (unsigned long)expected, numOfReceived,
+		CALIBRATION_NUM_OF_BYTES, good ? "" : ", wrong");
+	if(!good)
+	{
+		Calibration_globalErrors++;
+	}
+}
+
+static void Calibration_calibrate(uint16_t clock)
+{
+	Sim_reset();
+	Sim_setCycleLimit(10*(uint64_t)SYSTEM_CLK);
+	Timer0_setClock(0);
+	Calibration_globalResult = SWUART_AUTOBAUD_PENDING;
+	Calibration_globalClock = 0;
+	SWUART_calibrationStart(CALIBRATION_BAUDRATE);
+	uint32_t expected = Calibration_peer(CALIBRATION_BAUDRATE, clock);
+	Calibration_frame(CALIBRATION_FIRST_BYTE);
+	Calibration_frame(SWUART_SYNC_BYTE);
+	uint8_t numOfReceived = Calibration_bytes(0, 37);
+	Calibration_check("calibration", CALIBRATION_BAUDRATE, clock, Calibration_globalResult == SWUART_OK, expected,
+		CALIBRATION_TOLERANCE, numOfReceived);
+}
+
+static void Calibration_outOfRange(void)
+{
+	Sim_reset();
+	Sim_setCycleLimit(10*(uint64_t)SYSTEM_CLK);
+	Timer0_setClock(0);
+	Calibration_globalResult = SWUART_AUTOBAUD_PENDING;
+	SWUART_calibrationStart(CALIBRATION_BAUDRATE);
+	Calibration_peer(CALIBRATION_BAUDRATE, 10*CALIBRATION_OUT_OF_RANGE);
+	Calibration_frame(SWUART_SYNC_BYTE);
+	Calibration_frame(SWUART_SYNC_BYTE);
+	printf("out of range: result %d\n", Calibration_globalResult);
+	if(Calibration_globalResult == SWUART_OK)
+	{
+		Calibration_globalErrors++;
+	}
+}
+
+static void Calibration_track(uint32_t baudrate, uint16_t clock)
+{
+	En_SWUART_Error_t result = SWUART_NO_DATA;
+	uint8_t numOfFrames = 0;
+
+	Sim_reset();
+	Sim_setCycleLimit(10*(uint64_t)SYSTEM_CLK);
+	Timer0_setClock(0);
+	SWUART_init(baudrate);
+	SWUART_setClockTracking(1);
+	//the frames are sent without the calibration
+	Calibration_globalResult = SWUART_OK;
+	Calibration_globalClock = 0;
+	uint32_t expected = Calibration_peer(baudrate, clock);
+	while(numOfFrames < CALIBRATION_TRACK_MAX_FRAMES && result != SWUART_OK)
+	{
+		Calibration_frame((numOfFrames*53+1) & SWUART_DATA_MASK);
+		numOfFrames++;
+		while(SWUART_available() != 0)
+		{
+			SWUART_read();
+		}
+		result = SWUART_trackClock(&Calibration_globalClock);
+	}
+	uint8_t numOfReceived = Calibration_bytes(0, 29);
+	char name[24];
+	sprintf(name, "tracking of %u frames", numOfFrames);
+	Calibration_check(name, baudrate, clock, result == SWUART_OK, expected, CALIBRATION_TRACK_TOLERANCE, numOfReceived);
+}
+
+int main(void)
+{
+	for(uint8_t i = 0; i < sizeof(Calibration_clocks)/sizeof(Calibration_clocks[0]); i++)
+	{
+		Calibration_calibrate(Calibration_clocks[i]);
+	}
+	Calibration_outOfRange();
+	for(uint8_t i = 0; i < sizeof(Calibration_tracks)/sizeof(Calibration_tracks[0]); i++)
+	{
+		Calibration_track(Calibration_tracks[i].baudrate, Calibration_tracks[i].clock);
+	}
+	printf("errors %u\n", Calibration_globalErrors);
+	return Calibration_globalErrors != 0;
+}
+
+
+//////////////////////////////////////////////////////////
@@ -0,0 +1,200 @@
+//############# collision.c ##############
+/*
+ * Half-duplex run of the SW UART driver on the simulator.
+ * Two nodes share one open drain line, the sender on channel 1 and A1 and the listener on channel 0 and A0,
+ * wired together, and a third node is a peer driven on the same line with Sim_drive, in the frame format of the driver.
+ * The listener is served first in the tick, so it sees the start bit of the sender on the next tick,
+ * like a node on another MCU does.
+ * Build it like the loopback run in Sim.h with Simulator/collision.c instead of Simulator/loopback.c
+ * and -DSWUART_NUM_OF_CHANNELS=2 -DSWUART_HALF_DUPLEX=1.
+ *
+ * The cases are:
+ * bytes sent by each node, received by the other one and not by the node that sent them,
+ * the peer starting its frame with the start bit of the sender and winning the line on a bit where the sender
+ * sends a 1, both nodes then receive the frame of the peer and the sender sends its frame again,
+ * the peer sending the same byte as the sender with its bits 0.4 bit later, every bit is read back after the bit of
+ * the peer came, so there is no collision and the frame is received once,
+ * and a peer that wins every time, the sender drops its frame after SWUART_COLLISION_RETRIES.
+ * It returns 0 if every case received the expected bytes with the expected collision counts.
+ */
+#include <stdio.h>
+#include "SWUART.h"
+#include "Sim.h"
+
+#if SWUART_NUM_OF_CHANNELS < 2
+#error "the collision run needs 2 channels, build it with -DSWUART_NUM_OF_CHANNELS=2"
+#endif
+#if !SWUART_HALF_DUPLEX
+#error "the collision run needs the half-duplex mode, build it with -DSWUART_HALF_DUPLEX=1"
+#endif
+#if SWUART_DATA_BITS > 8
+#error "the peer sends bytes, build it with up to 8 data bits"
+#endif
+
+#define COLLISION_BAUDRATE		9600
+#define COLLISION_BIT_CYCLES	(SYSTEM_CLK/COLLISION_BAUDRATE)
+//the line is idle for a whole frame before a half-duplex node sends, this leaves it some more
+#define COLLISION_IDLE_CYCLES	(2*SWUART_FRAME_BITS*COLLISION_BIT_CYCLES)
+#define COLLISION_MAX_BYTES		8
+#define COLLISION_LISTENER		0
+#define COLLISION_SENDER		1
+
+static uint16_t Collision_globalErrors = 0;
+
+static void Collision_runUntil(uint64_t cycle)
+{
+	while(Sim_cycles() < cycle)
+	{
+		Sim_run(1);
+	}
+}
+
+//drives one frame of the peer on the line from now, in the frame format of the driver
+static void Collision_peerFrame(uint8_t data)
+{
+	uint8_t levels[SWUART_FRAME_BITS], ones = 0;
+	levels[0] = LOW;
+	for(uint8_t i = 0; i < SWUART_DATA_BITS; i++)
+	{
+#if SWUART_BIT_ORDER == SWUART_MSB_FIRST
+		levels[1+i] = (data >> (SWUART_DATA_BITS-1-i)) & 0x01;
+#else
+		levels[1+i] = (data >> i) & 0x01;
+#endif
+		ones += levels[1+i];
+	}
+	for(uint8_t i = 1+SWUART_DATA_BITS; i < SWUART_FRAME_BITS; i++)
+	{
+		levels[i] = HIGH;
+	}
+#if SWUART_PARITY == SWUART_PARITY_EVEN
+	levels[1+SWUART_DATA_BITS] = ones & 0x01;
+#elif SWUART_PARITY == SWUART_PARITY_ODD
+	levels[1+SWUART_DATA_BITS] = !(ones & 0x01);
+#elif SWUART_PARITY == SWUART_PARITY_SPACE
+	levels[1+SWUART_DATA_BITS] = LOW;
+#endif
+	//Sim_run doesn't count the cycles of the ISRs, so the bits are timed on the clock
+	uint64_t start = Sim_cycles();
+	for(uint8_t i = 0; i < SWUART_FRAME_BITS; i++)
+	{
+		Sim_drive(A, 0, levels[i]);
+		Collision_runUntil(start + (uint64_t)(i+1)*COLLISION_BIT_CYCLES);
+	}
+}
+
+static void Collision_waitIdle(void)
+{
+	while(!SWUART_channelTxIdle(COLLISION_SENDER) || !SWUART_channelTxIdle(COLLISION_LISTENER))
+	{
+		Sim_sleep();
+	}
+	Sim_run(COLLISION_IDLE_CYCLES);
+}
+
+//waits until the sender pulls its start bit
+static void Collision_waitStart(void)
+{
+	while(Sim_pinLevel(A, COLLISION_SENDER))
+	{
+		Sim_run(1);
+	}
+}
+
+//checks the bytes a node received, all without an error status
+static void Collision_expect(const char *name, uint8_t channel, const uint8_t *data, uint8_t length)
+{
+	SWUART_data_t received[COLLISION_MAX_BYTES];
+	uint8_t status, numOfReceived = 0, good = 1;
+	printf("%s: %s received", name, channel == COLLISION_SENDER ? "sender" : "listener");
+	while(SWUART_channelTryReceiveStatus(channel, &received[numOfReceived], &status) == SWUART_OK)
+	{
+		printf(" %02X/%u", (unsigned)received[numOfReceived], status);
+		good &= status == 0 && numOfReceived < length && received[numOfReceived] == data[numOfReceived];
+		if(numOfReceived < COLLISION_MAX_BYTES-1)
+		{
+			numOfReceived++;
+		}
+	}
+	good &= numOfReceived == length;
+	printf("%s\n", good ? "" : ", wrong");
+	if(!good)
+	{
+		Collision_globalErrors++;
+	}
+}
+
+static void Collision_expectStats(const char *name, uint16_t collisions, uint16_t txDropped)
+{
+	ST_SWUART_stats_t stats;
+	SWUART_channelGetStats(COLLISION_SENDER, &stats);
+	printf("%s: sender collisions %u, dropped %u\n", name, stats.collisions, stats.txDropped);
+	if(stats.collisions != collisions || stats.txDropped != txDropped)
+	{
+		Collision_globalErrors++;
+	}
+}
+
+int main(void)
+{
+	const uint8_t message[] = {0x48, 0x65, 0x00, 0xFF, 0x6C};
+	const uint8_t reply[] = {0x5A};
+
+	Sim_reset();
+	Sim_setCycleLimit(100*(uint64_t)SYSTEM_CLK);
+	Sim_wire(A, 0, A, 1);
+	SWUART_openHalfDuplex(COLLISION_LISTENER, A, COLLISION_LISTENER, COLLISION_BAUDRATE);
+	SWUART_openHalfDuplex(COLLISION_SENDER, A, COLLISION_SENDER, COLLISION_BAUDRATE);
+	Sim_run(COLLISION_IDLE_CYCLES);
+
+	//a node doesn't receive its own frames
+	SWUART_channelWrite(COLLISION_SENDER, message, sizeof(message));
+	Collision_waitIdle();
+	Collision_expect("sender sends", COLLISION_LISTENER, message, sizeof(message));
+	Collision_expect("sender sends", COLLISION_SENDER, 0, 0);
+	SWUART_channelWrite(COLLISION_LISTENER, reply, sizeof(reply));
+	Collision_waitIdle();
+	Collision_expect("listener sends", COLLISION_SENDER, reply, sizeof(reply));
+	Collision_expect("listener sends", COLLISION_LISTENER, 0, 0);
+	Collision_expectStats("no collision", 0, 0);
+
+	//the peer wins on the first data bit, then on the last one, the sender sends again once the line is idle
+	const uint8_t mine[] = {0xFF, 0xA5};
+	const uint8_t peer[] = {0x00, 0xA4};
+	for(uint8_t i = 0; i < sizeof(mine); i++)
+	{
+		const uint8_t both[] = {peer[i], mine[i]};
+		SWUART_channelSendAsync(COLLISION_SENDER, mine[i]);
+		Collision_waitStart();
+		Collision_peerFrame(peer[i]);
+		Collision_waitIdle();
+		Collision_expect("collision", COLLISION_SENDER, &peer[i], 1);
+		Collision_expect("collision", COLLISION_LISTENER, both, 2);
+		Collision_expectStats("collision", i+1, 0);
+	}
+
+	//the same byte 0.4 bit later, the line carries one good frame
+	const uint8_t same[] = {0xF0};
+	SWUART_channelSendAsync(COLLISION_SENDER, same[0]);
+	Collision_waitStart();
+	Collision_runUntil(Sim_cycles() + COLLISION_BIT_CYCLES*2/5);
+	Collision_peerFrame(same[0]);
+	Collision_waitIdle();
+	Collision_expect("late peer", COLLISION_LISTENER, same, 1);
+	Collision_expectStats("late peer", 2, 0);
+
+	//the peer wins every time
+	SWUART_channelSendAsync(COLLISION_SENDER, 0xFF);
+	for(uint8_t i = 0; i <= SWUART_COLLISION_RETRIES; i++)
+	{
+		Collision_waitStart();
+		Collision_peerFrame(0x00);
+	}
+	Collision_waitIdle();
+	Collision_expectStats("always lost", 2 + SWUART_COLLISION_RETRIES + 1, 1);
+	printf("errors %u\n", Collision_globalErrors);
+	return Collision_globalErrors != 0;
+}
+
+
+//////////////////////////////////////////////////////////
@@ -0,0 +1,108 @@
+//############# duplex.c ##############
+/*
+ * Full-duplex stress run of the SW UART driver on the simulator.
+ * Channel 0 is the device, it echoes every byte it receives like main.c does, channel 1 is the peer,
+ * it streams a pseudo random sequence back to back and checks the echo, so both lines carry frames
+ * back to back at the same time, sent and received by the same tick ISR.
+ * Build it like the loopback run in Sim.h with Simulator/duplex.c instead of Simulator/loopback.c
+ * and -DSWUART_NUM_OF_CHANNELS=2.
+ *
+ * For every baudrate one line is printed with the bytes sent, the bytes echoed back unchanged,
+ * the lost or changed bytes, the receive overruns of both channels, and the utilization of both lines:
+ * the frames they carried in percent of the frames the line could carry back to back in the run time.
+ * The line is counted at the nominal baudrate, a tick rounded down to whole timer counts makes the real bit time
+ * a bit shorter and the utilization can pass 100%.
+ * It returns 0 if every byte came back unchanged at every baudrate.
+ */
+#include <stdio.h>
+#include "SWUART.h"
+#include "Sim.h"
+
+#if SWUART_NUM_OF_CHANNELS < 2
+#error "the duplex run needs 2 channels, build it with -DSWUART_NUM_OF_CHANNELS=2"
+#endif
+
+#define DUPLEX_DEVICE			0
+#define DUPLEX_PEER				1
+#define DUPLEX_NUM_OF_BYTES		2000
+//cycles of the rest of a main loop pass, the polling functions don't touch the registers so they don't move the clock
+#define DUPLEX_LOOP_CYCLES		32
+
+static const uint32_t Duplex_baudrates[] = {9600, 19200, 38400, 57600};
+
+//16 bit Galois LFSR, the low bits of its state are the stream
+static uint16_t Duplex_next(uint16_t *state)
+{
+	*state = (*state >> 1) ^ (-(*state & 0x01) & 0xB400);
+	return *state;
+}
+
+static uint16_t Duplex_run(uint32_t baudrate)
+{
+	uint16_t txState = 0xACE1, rxState = 0xACE1;
+	uint16_t numOfSent = 0, numOfEchoed = 0, numOfErrors = 0;
+	SWUART_data_t data;
+	ST_SWUART_stats_t deviceStats, peerStats;
+
+	Sim_reset();
+	Sim_setCycleLimit(100*(uint64_t)SYSTEM_CLK);
+	//device TX A0 to peer RX A3, peer TX A2 to device RX A1
+	Sim_wire(A, 0, A, 3);
+	Sim_wire(A, 2, A, 1);
+	SWUART_open(DUPLEX_DEVICE, A, 0, 1, baudrate);
+	SWUART_open(DUPLEX_PEER, A, 2, 3, baudrate);
+
+	uint64_t start = Sim_cycles();
+	//the echo of the last byte ends one frame after the last byte
+	uint64_t timeout = start + 2*(uint64_t)SYSTEM_CLK*SWUART_FRAME_BITS*DUPLEX_NUM_OF_BYTES/baudrate;
+	while(numOfEchoed + numOfErrors < DUPLEX_NUM_OF_BYTES && Sim_cycles() < timeout)
+	{
+		//the peer keeps its transmit buffer full
+		while(numOfSent < DUPLEX_NUM_OF_BYTES && SWUART_channelTxFree(DUPLEX_PEER) != 0)
+		{
+			SWUART_channelSendAsync(DUPLEX_PEER, Duplex_next(&txState) & SWUART_DATA_MASK);
+			numOfSent++;
+		}
+		//the device echoes without blocking, a byte waits in the receive buffer while the transmit buffer is full
+		if(SWUART_channelTxFree(DUPLEX_DEVICE) != 0 && SWUART_channelTryReceive(DUPLEX_DEVICE, &data) == SWUART_OK)
+		{
+			SWUART_channelSendAsync(DUPLEX_DEVICE, data);
+		}
+		if(SWUART_channelTryReceive(DUPLEX_PEER, &data) == SWUART_OK)
+		{
+			if(data == (Duplex_next(&rxState) & SWUART_DATA_MASK))
+			{
+				numOfEchoed++;
+			}
+			else
+			{
+				numOfErrors++;
+			}
+		}
+		Sim_run(DUPLEX_LOOP_CYCLES);
+	}
+	uint64_t cycles = Sim_cycles() - start;
+	numOfErrors += DUPLEX_NUM_OF_BYTES - numOfEchoed - numOfErrors;
+	SWUART_channelGetStats(DUPLEX_DEVICE, &deviceStats);
+	SWUART_channelGetStats(DUPLEX_PEER, &peerStats);
+	double lineFrames = (double)cycles*baudrate/SYSTEM_CLK/SWUART_FRAME_BITS;
+	printf("%6lu baud: %u bytes sent, %u echoed, %u lost or changed, overruns %u/%u, utilization peer to device %.1f%%, device to peer %.1f%%\n",
+		(unsigned long)baudrate, numOfSent, numOfEchoed, numOfErrors, deviceStats.overruns, peerStats.overruns,
+		100.0*peerStats.txFrames/lineFrames, 100.0*deviceStats.txFrames/lineFrames);
+	SWUART_close(DUPLEX_DEVICE);
+	SWUART_close(DUPLEX_PEER);
+	return numOfErrors + deviceStats.overruns + peerStats.overruns;
+}
+
+int main(void)
+{
+	uint16_t errors = 0;
+	for(uint8_t i = 0; i < sizeof(Duplex_baudrates)/sizeof(Duplex_baudrates[0]); i++)
+	{
+		errors += Duplex_run(Duplex_baudrates[i]);
+	}
+	return errors != 0;
+}
+
+
+//////////////////////////////////////////////////////////
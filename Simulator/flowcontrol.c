@@ -0,0 +1,129 @@
+//############# flowcontrol.c ##############
+/*
+ * Flow control run of the SW UART driver on the simulator.
+ * Channel 0 is the sender, it keeps its transmit buffer full at 57600 baud, channel 1 is a slow reader,
+ * it takes one byte every 3 frame times, so its receive buffer fills up unless the sender is stopped.
+ * The data lines are A0 to A3 and A2 to A1, RTS of each channel is wired to CTS of the other on port B.
+ * Build it like the loopback run in Sim.h with Simulator/flowcontrol.c instead of Simulator/loopback.c
+ * and -DSWUART_NUM_OF_CHANNELS=2 -DSWUART_FLOW_CONTROL=1.
+ *
+ * The run is made without flow control, with RTS/CTS, with XON/XOFF and with both. For every run one line is printed
+ * with the bytes sent and read, the lost or changed bytes, the receive overruns and the most bytes
+ * the receive buffer held.
+ * It returns 0 if the run without flow control loses bytes, which shows the reader is slow enough,
+ * and every run with flow control reads every byte unchanged without an overrun.
+ */
+#include <stdio.h>
+#include "SWUART.h"
+#include "Sim.h"
+
+#if SWUART_NUM_OF_CHANNELS < 2
+#error "the flow control run needs 2 channels, build it with -DSWUART_NUM_OF_CHANNELS=2"
+#endif
+#if !SWUART_FLOW_CONTROL
+#error "the flow control run needs the flow control, build it with -DSWUART_FLOW_CONTROL=1"
+#endif
+
+#define FLOW_SENDER				0
+#define FLOW_READER				1
+#define FLOW_BAUDRATE			57600
+#define FLOW_NUM_OF_BYTES		1000
+//frame times between two reads of the slow reader
+#define FLOW_READ_FRAMES		3
+//cycles of the rest of a main loop pass
+#define FLOW_LOOP_CYCLES		50
+
+static const uint8_t Flow_modes[] =
+{
+	SWUART_FLOW_NONE, SWUART_FLOW_RTS_CTS, SWUART_FLOW_XON_XOFF, SWUART_FLOW_RTS_CTS | SWUART_FLOW_XON_XOFF
+};
+
+//the next byte of the stream, SWUART_XON and SWUART_XOFF are skipped as they are control characters with XON/XOFF
+static uint8_t Flow_next(uint8_t data, uint8_t mode)
+{
+	data++;
+	if((mode & SWUART_FLOW_XON_XOFF) && (data == SWUART_XON || data == SWUART_XOFF))
+	{
+		data++;
+	}
+	return data;
+}
+
+//returns the lost or changed bytes and the overruns
+static uint16_t Flow_run(uint8_t mode)
+{
+	uint16_t numOfSent = 0, numOfRead = 0, numOfErrors = 0;
+	uint8_t txData = 0, rxData = 0;
+	SWUART_data_t data;
+	ST_SWUART_stats_t readerStats;
+
+	Sim_reset();
+	Sim_setCycleLimit(100*(uint64_t)SYSTEM_CLK);
+	Sim_wire(A, 0, A, 3);
+	Sim_wire(A, 2, A, 1);
+	//RTS of the sender B0 to CTS of the reader B1, RTS of the reader B2 to CTS of the sender B3
+	Sim_wire(B, 0, B, 1);
+	Sim_wire(B, 2, B, 3);
+	SWUART_open(FLOW_SENDER, A, 0, 1, FLOW_BAUDRATE);
+	SWUART_open(FLOW_READER, A, 2, 3, FLOW_BAUDRATE);
+	if(mode != SWUART_FLOW_NONE)
+	{
+		if(SWUART_channelSetFlowControl(FLOW_SENDER, mode, B, 0, 3) != SWUART_OK
+			|| SWUART_channelSetFlowControl(FLOW_READER, mode, B, 2, 1) != SWUART_OK)
+		{
+			printf("mode %u: flow control not set\n", mode);
+			numOfErrors++;
+		}
+	}
+
+	uint64_t frameCycles = (uint64_t)SYSTEM_CLK*SWUART_FRAME_BITS/FLOW_BAUDRATE;
+	uint64_t lastRead = Sim_cycles();
+	//the reader takes FLOW_READ_FRAMES frame times a byte, twice that is left for the stops
+	uint64_t timeout = lastRead + 2*FLOW_READ_FRAMES*frameCycles*FLOW_NUM_OF_BYTES;
+	while(numOfRead < FLOW_NUM_OF_BYTES && Sim_cycles() < timeout)
+	{
+		while(numOfSent < FLOW_NUM_OF_BYTES && SWUART_channelSendAsync(FLOW_SENDER, txData) == SWUART_OK)
+		{
+			txData = Flow_next(txData, mode);
+			numOfSent++;
+		}
+		if(Sim_cycles() - lastRead >= FLOW_READ_FRAMES*frameCycles)
+		{
+			if(SWUART_channelTryReceive(FLOW_READER, &data) == SWUART_OK)
+			{
+				//after a lost byte the stream is followed from the byte read
+				if(data != rxData)
+				{
+					numOfErrors++;
+					rxData = data;
+				}
+				rxData = Flow_next(rxData, mode);
+				numOfRead++;
+			}
+			lastRead = Sim_cycles();
+		}
+		Sim_run(FLOW_LOOP_CYCLES);
+	}
+	SWUART_channelGetStats(FLOW_READER, &readerStats);
+	numOfErrors += FLOW_NUM_OF_BYTES - numOfRead;
+	printf("mode %u: %u bytes sent, %u read, %u lost or changed, overruns %u, receive buffer up to %u bytes\n",
+		mode, numOfSent, numOfRead, numOfErrors, readerStats.overruns, readerStats.maxRxUsed);
+	SWUART_close(FLOW_SENDER);
+	SWUART_close(FLOW_READER);
+	return numOfErrors + readerStats.overruns;
+}
+
+int main(void)
+{
+	uint8_t failed = 0;
+	for(uint8_t i = 0; i < sizeof(Flow_modes)/sizeof(Flow_modes[0]); i++)
+	{
+		uint16_t errors = Flow_run(Flow_modes[i]);
+		//the run without flow control must lose bytes, the others none
+		failed += Flow_modes[i] == SWUART_FLOW_NONE ? errors == 0 : errors != 0;
+	}
+	return failed != 0;
+}
+
+
+//////////////////////////////////////////////////////////
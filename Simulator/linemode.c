@@ -0,0 +1,172 @@
+//############# linemode.c ##############
+/*
+ * Line mode run of the SW UART driver on the simulator.
+ * The TX pin of the default channel is wired to its RX pin and the channel receives its own lines
+ * into two line buffers of LINE_BUFFER_SIZE bytes.
+ * Build it like the loopback run in Sim.h with Simulator/linemode.c instead of Simulator/loopback.c
+ * and -DSWUART_LINE_MODE=1.
+ *
+ * The cases are:
+ * a line read in place in the first buffer, while it is held the next line fills the second buffer,
+ * a third line that ends while both buffers are held waits, the bytes after it are dropped and the next line
+ * carries SWUART_STATUS_OVERRUN,
+ * a line longer than a buffer is cut with SWUART_STATUS_LINE_OVERFLOW and its rest is the next line,
+ * an empty line, a release without a line, the line mode turned off, which gives the bytes to the receive buffer again,
+ * and LINE_NUM_OF_LINES short lines back to back, every line released as soon as it is read.
+ * It returns 0 if every line came in the expected buffer with the expected bytes and status.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "SWUART.h"
+#include "Sim.h"
+
+#if !SWUART_LINE_MODE
+#error "the line mode run needs the line mode, build it with -DSWUART_LINE_MODE=1"
+#endif
+
+#define LINE_BAUDRATE			9600
+#define LINE_BUFFER_SIZE		16
+#define LINE_DELIMITER			'\n'
+#define LINE_NUM_OF_LINES		40
+
+static SWUART_data_t Line_globalBuffer0[LINE_BUFFER_SIZE];
+static SWUART_data_t Line_globalBuffer1[LINE_BUFFER_SIZE];
+static uint16_t Line_globalErrors = 0;
+
+static void Line_send(const char *text)
+{
+	while(*text)
+	{
+		SWUART_send((uint8_t)*text++);
+	}
+}
+
+//runs until the last frame is sent and received
+static void Line_flush(void)
+{
+	while(!SWUART_txIdle())
+	{
+		Sim_run(100);
+	}
+	Sim_run(2*SWUART_FRAME_BITS*(SYSTEM_CLK/LINE_BAUDRATE));
+}
+
+static uint8_t Line_is(const SWUART_data_t *line, uint8_t length, const char *text)
+{
+	uint8_t good = length == strlen(text);
+	for(uint8_t i = 0; i < length && good; i++)
+	{
+		good = line[i] == (uint8_t)text[i];
+	}
+	return good;
+}
+
+//checks the next line: its text, the buffer it is in if buffer isn't 0, and its status flags
+static void Line_expect(const char *name, const char *text, const SWUART_data_t *buffer, uint8_t status)
+{
+	SWUART_data_t *line = 0;
+	uint8_t length = 0, lineStatus = 0;
+	En_SWUART_Error_t result = SWUART_tryReceiveLine(&line, &length, &lineStatus);
+	uint8_t good = result == SWUART_OK && Line_is(line, length, text) && lineStatus == status
+		&& (buffer == 0 || line == buffer);
+	printf("%s: result %d, %u bytes, status %02X%s\n", name, result, length, lineStatus, good ? "" : ", wrong");
+	if(!good)
+	{
+		Line_globalErrors++;
+	}
+}
+
+static void Line_check(const char *name, uint8_t good)
+{
+	if(!good)
+	{
+		printf("%s: wrong\n", name);
+		Line_globalErrors++;
+	}
+}
+
+int main(void)
+{
+	SWUART_data_t *line;
+	uint8_t length, status;
+	SWUART_data_t data = 0;
+
+	Sim_reset();
+	Sim_setCycleLimit(100*(uint64_t)SYSTEM_CLK);
+	Sim_wire(UART_PORT, TX, UART_RX_PORT, RX);
+	SWUART_init(LINE_BAUDRATE);
+	Line_check("no line mode", SWUART_tryReceiveLine(&line, &length, &status) == SWUART_NO_DATA);
+	Line_check("line mode on", SWUART_setLineMode(Line_globalBuffer0, Line_globalBuffer1, LINE_BUFFER_SIZE, LINE_DELIMITER) == SWUART_OK);
+
+	//the line is read in place, and held while the next one fills the other buffer
+	Line_send("hello\n");
+	Line_flush();
+	Line_expect("first line", "hello", Line_globalBuffer0, SWUART_STATUS_OK);
+	Line_send("world\n");
+	Line_flush();
+	Line_expect("first line held", "hello", Line_globalBuffer0, SWUART_STATUS_OK);
+	SWUART_releaseLine();
+	Line_expect("second line", "world", Line_globalBuffer1, SWUART_STATUS_OK);
+
+	//the third line waits in the first buffer while the second is held, the bytes after it are dropped
+	Line_send("third\nlost\nnext\n");
+	Line_flush();
+	SWUART_releaseLine();
+	Line_expect("waiting line", "third", Line_globalBuffer0, SWUART_STATUS_OK);
+	SWUART_releaseLine();
+	Line_check("dropped lines", SWUART_tryReceiveLine(&line, &length, &status) == SWUART_NO_DATA);
+	Line_send("ok\n");
+	Line_flush();
+	Line_expect("line after the dropped bytes", "ok", 0, SWUART_STATUS_OVERRUN);
+	SWUART_releaseLine();
+
+	//the long line fills its buffer, the rest of it is the next line
+	Line_send("0123456789ABCDEFxyz\n");
+	Line_flush();
+	Line_expect("long line", "0123456789ABCDEF", 0, SWUART_STATUS_LINE_OVERFLOW);
+	SWUART_releaseLine();
+	Line_expect("rest of the long line", "xyz", 0, SWUART_STATUS_OK);
+	SWUART_releaseLine();
+	Line_check("release without a line", SWUART_channelReleaseLine(SWUART_DEFAULT_CHANNEL) == SWUART_NO_DATA);
+	Line_send("\n");
+	Line_flush();
+	Line_expect("empty line", "", 0, SWUART_STATUS_OK);
+	SWUART_releaseLine();
+	Line_check("no buffer receive", SWUART_channelReceiveBuffer(SWUART_DEFAULT_CHANNEL, &data, 1, 10) == 0);
+
+	//without the line mode the bytes go to the receive buffer again
+	Line_check("line mode off", SWUART_setLineMode(0, 0, 0, LINE_DELIMITER) == SWUART_OK);
+	Line_check("no line to wait", SWUART_channelReceiveLine(SWUART_DEFAULT_CHANNEL, &line, &length, &status) == SWUART_NO_DATA);
+	Line_send("r");
+	Line_flush();
+	Line_check("receive buffer", SWUART_tryReceive(&data) == SWUART_OK && data == 'r');
+
+	//the lines come back to back while the application reads them
+	char text[LINE_NUM_OF_LINES*5+1] = "";
+	for(uint8_t i = 0; i < LINE_NUM_OF_LINES; i++)
+	{
+		sprintf(text + strlen(text), "L%u\n", i);
+	}
+	SWUART_setLineMode(Line_globalBuffer0, Line_globalBuffer1, LINE_BUFFER_SIZE, LINE_DELIMITER);
+	const char *next = text;
+	uint8_t numOfGood = 0;
+	for(uint8_t i = 0; i < LINE_NUM_OF_LINES; i++)
+	{
+		char expected[5];
+		while(*next && SWUART_txFree() != 0)
+		{
+			SWUART_sendAsync((uint8_t)*next++);
+		}
+		SWUART_receiveLine(&line, &length, &status);
+		sprintf(expected, "L%u", i);
+		numOfGood += Line_is(line, length, expected) && status == SWUART_STATUS_OK;
+		SWUART_releaseLine();
+	}
+	printf("back to back: %u of %u lines\n", numOfGood, LINE_NUM_OF_LINES);
+	Line_check("back to back", numOfGood == LINE_NUM_OF_LINES);
+	printf("errors %u\n", Line_globalErrors);
+	return Line_globalErrors != 0;
+}
+
+
+//////////////////////////////////////////////////////////
@@ -0,0 +1,75 @@
+//############# loopback.c ##############
+/*
+ * Host loopback run of the SW UART driver on the simulator, see Sim.h for the build command.
+ * TX is wired to RX, every byte is sent with SWUART_send and read back with SWUART_recieve,
+ * and the time of each byte is reported in simulated cycles.
+ * Then the whole message is streamed with SWUART_sendBuffer and read back with SWUART_receiveBuffer,
+ * and the wire utilization is reported against the ideal back to back frames.
+ * For both runs the cycles the CPU was awake are reported per byte, the rest it slept in the driver waits.
+ * It returns 0 if all the bytes came back unchanged.
+ */
+#include <stdio.h>
+#include "SWUART.h"
+#include "Sim.h"
+
+#define LOOPBACK_BAUDRATE	9600
+#if SWUART_DATA_BITS > 8
+#error "the loopback message is made of bytes, build it with up to 8 data bits"
+#endif
+
+int main(void)
+{
+	const uint8_t message[] = "SW UART loopback 0123456789";
+	uint8_t errors = 0;
+	Sim_reset();
+	//stop a driver that waits forever instead of hanging the host
+	Sim_setCycleLimit(100*(uint64_t)SYSTEM_CLK);
+	Sim_wire(UART_PORT, TX, UART_RX_PORT, RX);
+	SWUART_init(LOOPBACK_BAUDRATE);
+
+	uint64_t start = Sim_cycles();
+	uint64_t sleepStart = Sim_sleepCycles();
+	for(uint8_t i = 0; i < sizeof(message)-1; i++)
+	{
+		uint8_t data = 0;
+		uint64_t byteStart = Sim_cycles();
+		SWUART_send(message[i]);
+		SWUART_recieve(&data);
+		if(data != (message[i] & SWUART_DATA_MASK))
+		{
+			errors++;
+		}
+		printf("sent 0x%02X received 0x%02X in %llu cycles\n", message[i], data, (unsigned long long)(Sim_cycles() - byteStart));
+	}
+	uint64_t cycles = Sim_cycles() - start;
+	uint64_t awake = cycles - (Sim_sleepCycles() - sleepStart);
+	printf("%u bytes at %u baud, SYSTEM_CLK %lu Hz: %llu cycles, %llu cycles per byte, %u errors\n",
+		(unsigned)(sizeof(message)-1), LOOPBACK_BAUDRATE, (unsigned long)SYSTEM_CLK,
+		(unsigned long long)cycles, (unsigned long long)(cycles/(sizeof(message)-1)), errors);
+	printf("awake %llu cycles per byte, %.1f%% of the cycles\n",
+		(unsigned long long)(awake/(sizeof(message)-1)), 100.0*awake/cycles);
+
+	uint8_t received[sizeof(message)-1];
+	uint8_t bulkErrors = 0;
+	start = Sim_cycles();
+	sleepStart = Sim_sleepCycles();
+	SWUART_sendBuffer(message, sizeof(message)-1);
+	uint16_t numOfReceived = SWUART_receiveBuffer(received, sizeof(received), 1000);
+	cycles = Sim_cycles() - start;
+	awake = cycles - (Sim_sleepCycles() - sleepStart);
+	for(uint8_t i = 0; i < sizeof(received); i++)
+	{
+		bulkErrors += i >= numOfReceived || received[i] != (message[i] & SWUART_DATA_MASK);
+	}
+	//the last byte is in the buffer after the middle of its first stop bit
+	uint64_t idealCycles = (uint64_t)SYSTEM_CLK*((sizeof(message)-1)*SWUART_FRAME_BITS - SWUART_FRAME_BITS + 1+SWUART_DATA_BITS+SWUART_PARITY_BITS)/LOOPBACK_BAUDRATE;
+	printf("buffer of %u bytes: %llu cycles, %llu cycles per byte, wire utilization %.1f%%, %u errors\n",
+		(unsigned)(sizeof(message)-1), (unsigned long long)cycles, (unsigned long long)(cycles/(sizeof(message)-1)),
+		100.0*idealCycles/cycles, bulkErrors);
+	printf("awake %llu cycles per byte, %.1f%% of the cycles\n",
+		(unsigned long long)(awake/(sizeof(message)-1)), 100.0*awake/cycles);
+	return errors != 0 || bulkErrors != 0;
+}
+
+
+//////////////////////////////////////////////////////////
@@ -0,0 +1,124 @@
+//############# multidrop.c ##############
+/*
+ * Multidrop addressing run of the SW UART driver on the simulator.
+ * The TX pin of the default channel is wired to its RX pin, the channel sends address frames with
+ * SWUART_channelSendAddress and data frames to several nodes and receives them as node MULTIDROP_NODE.
+ * Build it like the loopback run in Sim.h with Simulator/multidrop.c instead of Simulator/loopback.c
+ * and -DSWUART_DATA_BITS=9.
+ *
+ * The cases are:
+ * without the multidrop addressing every frame is received, the address frames with SWUART_ADDRESS_MARK,
+ * with it the data before the first address and the frames for the other nodes are dropped, among them more frames
+ * than the receive buffer holds, and the address frames of the node and their data frames are received,
+ * then the addressing turned off again and opening the channel again, which turns it off.
+ * It returns 0 if every case received exactly the expected frames without an overrun.
+ */
+#include <stdio.h>
+#include "SWUART.h"
+#include "Sim.h"
+
+#if SWUART_DATA_BITS != 9
+#error "the multidrop run needs the address bit, build it with -DSWUART_DATA_BITS=9"
+#endif
+
+#define MULTIDROP_BAUDRATE		9600
+#define MULTIDROP_NODE			5
+#define MULTIDROP_MAX_FRAMES	64
+//frames sent to another node, more than the receive buffer holds
+#define MULTIDROP_OTHER_FRAMES	40
+//longest wait for the frames of a case in milliseconds
+#define MULTIDROP_TIMEOUT		200
+
+static uint16_t Multidrop_globalErrors = 0;
+
+//receives the frames of a case until the line is quiet and checks them
+static void Multidrop_expect(const char *name, const SWUART_data_t *expected, uint16_t length)
+{
+	SWUART_data_t received[MULTIDROP_MAX_FRAMES];
+	uint16_t numOfReceived = SWUART_receiveBuffer(received, MULTIDROP_MAX_FRAMES, MULTIDROP_TIMEOUT);
+	uint8_t good = numOfReceived == length;
+	printf("%s: received", name);
+	for(uint16_t i = 0; i < numOfReceived; i++)
+	{
+		printf(" %03X", (unsigned)received[i]);
+		good &= i < length && received[i] == expected[i];
+	}
+	printf("%s\n", good ? "" : ", wrong");
+	if(!good)
+	{
+		Multidrop_globalErrors++;
+	}
+}
+
+int main(void)
+{
+	ST_SWUART_stats_t stats;
+
+	Sim_reset();
+	Sim_setCycleLimit(100*(uint64_t)SYSTEM_CLK);
+	Sim_wire(UART_PORT, TX, UART_RX_PORT, RX);
+	SWUART_init(MULTIDROP_BAUDRATE);
+
+	//without the addressing the address frames are data with the mark
+	const SWUART_data_t all[] = {SWUART_ADDRESS_MARK | 3, 0x1AB, 0x22};
+	SWUART_sendAddress(3);
+	SWUART_send(0x1AB);
+	SWUART_send(0x22);
+	Multidrop_expect("addressing off", all, sizeof(all)/sizeof(all[0]));
+
+	//the node gets its address frames and their data only
+	if(SWUART_setMultidrop(1, MULTIDROP_NODE) != SWUART_OK)
+	{
+		printf("addressing not set\n");
+		Multidrop_globalErrors++;
+	}
+	SWUART_resetStats();
+	SWUART_send(0x10);
+	SWUART_send(0x11);
+	SWUART_sendAddress(3);
+	SWUART_send(0x30);
+	SWUART_sendAddress(MULTIDROP_NODE);
+	SWUART_send(0x50);
+	SWUART_send(0x51);
+	SWUART_send(0x52);
+	SWUART_sendAddress(7);
+	for(uint8_t i = 0; i < MULTIDROP_OTHER_FRAMES; i++)
+	{
+		SWUART_send(0x70 + i);
+	}
+	SWUART_sendAddress(MULTIDROP_NODE);
+	SWUART_send(0x53);
+	//an address frame for the node while it is addressed starts a new message
+	SWUART_sendAddress(MULTIDROP_NODE);
+	SWUART_send(0x54);
+	SWUART_sendAddress(6);
+	SWUART_send(0x60);
+	const SWUART_data_t mine[] =
+	{
+		SWUART_ADDRESS_MARK | MULTIDROP_NODE, 0x50, 0x51, 0x52,
+		SWUART_ADDRESS_MARK | MULTIDROP_NODE, 0x53,
+		SWUART_ADDRESS_MARK | MULTIDROP_NODE, 0x54
+	};
+	Multidrop_expect("addressing on", mine, sizeof(mine)/sizeof(mine[0]));
+	SWUART_getStats(&stats);
+	printf("addressing on: overruns %u, receive buffer up to %u frames\n", stats.overruns, stats.maxRxUsed);
+	if(stats.overruns != 0 || stats.maxRxUsed > sizeof(mine)/sizeof(mine[0]))
+	{
+		Multidrop_globalErrors++;
+	}
+
+	//turned off, and turned off by opening the channel again
+	const SWUART_data_t data[] = {0x99};
+	SWUART_setMultidrop(0, MULTIDROP_NODE);
+	SWUART_send(data[0]);
+	Multidrop_expect("addressing turned off", data, 1);
+	SWUART_setMultidrop(1, MULTIDROP_NODE);
+	SWUART_init(MULTIDROP_BAUDRATE);
+	SWUART_send(data[0]);
+	Multidrop_expect("channel opened again", data, 1);
+	printf("errors %u\n", Multidrop_globalErrors);
+	return Multidrop_globalErrors != 0;
+}
+
+
+//////////////////////////////////////////////////////////
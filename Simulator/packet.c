@@ -0,0 +1,178 @@
+//############# packet.c ##############
+/*
+ * Packet layer run on the simulator.
+ * The TX pin of the channel is wired to its RX pin. A short packet is sent with SWUART_channelSendPacket and
+ * read back with SWUART_channelPollPacket. The longer runs don't fit in the receive buffer, so a software timer
+ * takes the received bytes out while the packet is sent, and the main code feeds them to SWUART_packetDecode:
+ * a packet of exactly 254 nonzero bytes, a full COBS block with no 0 after it, a packet ending with a 0,
+ * a packet with a corrupted byte that must end with SWUART_PACKET_CRC_ERROR while the next one is received,
+ * and a packet too long for the buffer of the decoder followed by a good one.
+ * Build it like the loopback run in Sim.h with Simulator/packet.c instead of Simulator/loopback.c
+ * and "MCAL/Software UART/SWUARTPacket.c".
+ *
+ * It returns 0 if every packet ended with the expected result and the good ones came back unchanged.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "TimerService.h"
+#include "SWUARTPacket.h"
+#include "Sim.h"
+
+#define PACKET_BAUDRATE			9600
+#define PACKET_STREAM_SIZE		600
+#define PACKET_BUFFER_SIZE		300
+#define PACKET_SHORT_SIZE		16
+//frames between the timer calls that take the received bytes, well below the free places of the receive buffer
+#define PACKET_DRAIN_FRAMES		4
+
+static SWUART_data_t Packet_globalStream[PACKET_STREAM_SIZE];
+static uint8_t Packet_globalStatus[PACKET_STREAM_SIZE];
+static volatile uint16_t Packet_globalNumOfBytes = 0;
+static uint16_t Packet_globalErrors = 0;
+
+//called with the interrupts disabled, the receive functions enable them only for the flow control that isn't used here
+static void Packet_drain(void)
+{
+	SWUART_data_t data;
+	uint8_t status;
+	while(Packet_globalNumOfBytes < PACKET_STREAM_SIZE && SWUART_channelTryReceiveStatus(0, &data, &status) == SWUART_OK)
+	{
+		Packet_globalStream[Packet_globalNumOfBytes] = data;
+		Packet_globalStatus[Packet_globalNumOfBytes] = status;
+		Packet_globalNumOfBytes++;
+	}
+}
+
+//runs until the last frame is sent and received
+static void Packet_flush(void)
+{
+	while(!SWUART_channelTxIdle(0))
+	{
+		Sim_run(100);
+	}
+	Sim_run(2*PACKET_DRAIN_FRAMES*SWUART_FRAME_BITS*(SYSTEM_CLK/PACKET_BAUDRATE));
+}
+
+static void Packet_send(const uint8_t *data, uint16_t length)
+{
+	if(SWUART_channelSendPacket(0, data, length) != SWUART_PACKET_OK)
+	{
+		printf("packet of %u bytes not sent\n", length);
+		Packet_globalErrors++;
+	}
+}
+
+//feeds the captured bytes from *next to the decoder until a packet ends, and checks its result and its data
+static void Packet_expect(const char *name, ST_SWUART_packetDecoder_t *decoder, uint16_t *next,
+	En_SWUART_Packet_Error_t result, const uint8_t *data, uint16_t length)
+{
+	En_SWUART_Packet_Error_t got = SWUART_PACKET_PENDING;
+	while(got == SWUART_PACKET_PENDING && *next < Packet_globalNumOfBytes)
+	{
+		got = SWUART_packetDecode(decoder, (uint8_t)Packet_globalStream[*next], Packet_globalStatus[*next]);
+		(*next)++;
+	}
+	uint8_t good = got == result;
+	if(good && result == SWUART_PACKET_OK)
+	{
+		good = decoder->length == length && memcmp(decoder->buffer, data, length) == 0;
+	}
+	printf("%s: result %d, expected %d, %u data bytes%s\n", name, got, result, decoder->length, good ? "" : ", wrong");
+	if(!good)
+	{
+		Packet_globalErrors++;
+	}
+}
+
+int main(void)
+{
+	static uint8_t data[PACKET_BUFFER_SIZE], other[PACKET_SHORT_SIZE], buffer[PACKET_BUFFER_SIZE];
+	const uint8_t message[] = "SW UART\0packet";
+	ST_SWUART_packetDecoder_t decoder;
+	En_SWUART_Packet_Error_t result = SWUART_PACKET_PENDING;
+	uint16_t next;
+
+	Sim_reset();
+	Sim_setCycleLimit(100*(uint64_t)SYSTEM_CLK);
+	Sim_wire(A, 0, A, 1);
+	SWUART_open(0, A, 0, 1, PACKET_BAUDRATE);
+	TimerService_init(clkI_DIVISION_BY_8);
+
+	//a short packet with a 0 in it fits in the receive buffer
+	SWUART_packetDecoderInit(&decoder, buffer, PACKET_BUFFER_SIZE);
+	Packet_send(message, sizeof(message));
+	Packet_flush();
+	while(result == SWUART_PACKET_PENDING && SWUART_channelAvailable(0) != 0)
+	{
+		result = SWUART_channelPollPacket(0, &decoder);
+	}
+	uint8_t good = result == SWUART_PACKET_OK && decoder.length == sizeof(message) && memcmp(buffer, message, sizeof(message)) == 0;
+	printf("loopback: result %d, %u data bytes%s\n", result, decoder.length, good ? "" : ", wrong");
+	Packet_globalErrors += !good;
+
+	//the longer packets are taken out of the receive buffer while they are sent
+	uint32_t drainTicks = Timer0_getClock()/Timer0_getPrescaler()*PACKET_DRAIN_FRAMES*SWUART_FRAME_BITS/PACKET_BAUDRATE;
+	TimerService_start(0, drainTicks, drainTicks, Packet_drain);
+
+	//254 nonzero bytes are a full block, its code 0xFF has no 0 after it
+	for(uint16_t i = 0; i < 254; i++)
+	{
+		data[i] = i + 1;
+	}
+	Packet_globalNumOfBytes = 0;
+	Packet_send(data, 254);
+	Packet_flush();
+	next = 0;
+	if(Packet_globalStream[0] != 0xFF)
+	{
+		printf("254 nonzero bytes: the first block code is %02X\n", (unsigned)Packet_globalStream[0]);
+		Packet_globalErrors++;
+	}
+	Packet_expect("254 nonzero bytes", &decoder, &next, SWUART_PACKET_OK, data, 254);
+
+	//the 0 at the end of the data is the last byte before the CRC
+	data[9] = 0;
+	Packet_globalNumOfBytes = 0;
+	Packet_send(data, 10);
+	Packet_flush();
+	next = 0;
+	Packet_expect("trailing zero", &decoder, &next, SWUART_PACKET_OK, data, 10);
+
+	//a data byte changed on the line, still nonzero, the next packet is received after the delimiter
+	for(uint8_t i = 0; i < PACKET_SHORT_SIZE; i++)
+	{
+		data[i] = i + 1;
+		other[i] = 0xA0 + i;
+	}
+	Packet_globalNumOfBytes = 0;
+	Packet_send(data, PACKET_SHORT_SIZE);
+	Packet_send(other, PACKET_SHORT_SIZE);
+	Packet_flush();
+	Packet_globalStream[3] ^= 0x10;
+	next = 0;
+	Packet_expect("corrupted byte", &decoder, &next, SWUART_PACKET_CRC_ERROR, data, PACKET_SHORT_SIZE);
+	Packet_expect("after the corrupted byte", &decoder, &next, SWUART_PACKET_OK, other, PACKET_SHORT_SIZE);
+
+	//a decoder with a short buffer drops the long packet and takes the next one
+	SWUART_packetDecoderInit(&decoder, buffer, PACKET_SHORT_SIZE);
+	Packet_globalNumOfBytes = 0;
+	Packet_send(data, 40);
+	Packet_send(other, PACKET_SHORT_SIZE);
+	Packet_flush();
+	next = 0;
+	Packet_expect("too long", &decoder, &next, SWUART_PACKET_TOO_LONG, data, 40);
+	Packet_expect("after the long packet", &decoder, &next, SWUART_PACKET_OK, other, PACKET_SHORT_SIZE);
+
+	//no byte of a closed channel is queued
+	SWUART_close(0);
+	if(SWUART_channelSendPacket(0, data, PACKET_SHORT_SIZE) != SWUART_PACKET_WRONG_CHANNEL)
+	{
+		printf("closed channel: the packet isn't refused\n");
+		Packet_globalErrors++;
+	}
+	printf("errors %u\n", Packet_globalErrors);
+	return Packet_globalErrors != 0;
+}
+
+
+//////////////////////////////////////////////////////////
@@ -0,0 +1,148 @@
+//############# print.c ##############
+/*
+ * Number printing benchmark of SWUARTPrint on the simulator.
+ * The same pseudo random numbers, from 1 to 10 digits, are sent three ways on the default channel:
+ *   printU32  SWUART_printU32, the digits made by subtracting powers of ten
+ *   printf    SWUART_printf with "%lu"
+ *   divide    the digits made with % 10 and / 10 into a small buffer, sent in reverse
+ * TX is wired to RX, and everything received back is checked against sprintf.
+ * Build it like the loopback run in Sim.h with Simulator/print.c instead of Simulator/loopback.c,
+ * "MCAL/Software UART/SWUARTPrint.c", -DSWUART_TX_BUFFER_SIZE=128 and -DSWUART_RX_BUFFER_SIZE=128.
+ *
+ * The simulator doesn't run the CPU, and the host divides in hardware, so time on the host says nothing about
+ * the AVR. What carries over is the work done per number: the compare and subtract steps of SWUARTPrint,
+ * counted by the host build of it in 32 bit and in 16 bit, and the 32 bit divisions of the divide way.
+ * The AVR has no divide instruction, every division is a call to __udivmodsi4 of libgcc, a loop of 32
+ * shift, compare and subtract steps in 32 bit, one call per digit as the quotient and the remainder come
+ * from the same call. So the divisions are also given in 32 bit steps, PRINT_DIVISION_STEPS each.
+ * For every way one line is printed with the steps and divisions per number, and the numbers received back
+ * unchanged. It returns 0 if all of them came back unchanged.
+ */
+#include <stdio.h>
+#include "SWUARTPrint.h"
+#include "Sim.h"
+
+#define PRINT_BAUDRATE			38400
+#define PRINT_NUM_OF_NUMBERS	2000
+//numbers sent between two waits for the line, at most 11 characters each with the separator
+#define PRINT_BATCH				10
+//loop steps of one __udivmodsi4 call
+#define PRINT_DIVISION_STEPS	32
+//milliseconds SWUART_receiveBuffer waits for a batch, far more than its frames take
+#define PRINT_TIMEOUT			100
+
+#if SWUART_TX_BUFFER_SIZE <= 11*PRINT_BATCH || SWUART_RX_BUFFER_SIZE < 11*PRINT_BATCH
+#error "a batch must fit in the buffers, build it with -DSWUART_TX_BUFFER_SIZE=128 -DSWUART_RX_BUFFER_SIZE=128"
+#endif
+#if SWUART_DATA_BITS < 8
+#error "the numbers are checked as bytes, build it with 8 or more data bits"
+#endif
+
+typedef struct
+{
+	const char *name;
+	void (*print)(uint32_t value);
+}ST_Print_way_t;
+
+static uint32_t Print_numbers[PRINT_NUM_OF_NUMBERS];
+//32 bit divisions made by Print_divide
+static uint32_t Print_divisions = 0;
+
+static void Print_printU32(uint32_t value)
+{
+	SWUART_printU32(value);
+}
+
+static void Print_printf(uint32_t value)
+{
+	SWUART_printf("%lu", (unsigned long)value);
+}
+
+static void Print_divide(uint32_t value)
+{
+	char digits[10];
+	uint8_t numOfDigits = 0;
+	do
+	{
+		digits[numOfDigits++] = '0' + value % 10;
+		value /= 10;
+		Print_divisions++;
+	}while(value != 0);
+	while(numOfDigits > 0)
+	{
+		SWUART_send(digits[--numOfDigits]);
+	}
+}
+
+static const ST_Print_way_t Print_ways[] =
+{
+	{"printU32", Print_printU32},
+	{"printf", Print_printf},
+	{"divide", Print_divide}
+};
+
+//returns the numbers received back unchanged
+static uint16_t Print_run(const ST_Print_way_t *way)
+{
+	uint16_t numOfGood = 0;
+	SWUART_printLongSteps = 0;
+	SWUART_printShortSteps = 0;
+	Print_divisions = 0;
+	for(uint16_t first = 0; first < PRINT_NUM_OF_NUMBERS; first += PRINT_BATCH)
+	{
+		char expected[11*PRINT_BATCH+1];
+		SWUART_data_t received[11*PRINT_BATCH];
+		uint16_t length = 0;
+		for(uint16_t i = first; i < first + PRINT_BATCH; i++)
+		{
+			length += sprintf(&expected[length], "%lu,", (unsigned long)Print_numbers[i]);
+		}
+		for(uint16_t i = first; i < first + PRINT_BATCH; i++)
+		{
+			way->print(Print_numbers[i]);
+			SWUART_send(',');
+		}
+		uint16_t numOfReceived = SWUART_receiveBuffer(received, length, PRINT_TIMEOUT);
+		//a number is good if it and its separator came back unchanged
+		uint8_t good = 1;
+		for(uint16_t i = 0; i < length; i++)
+		{
+			good &= i < numOfReceived && received[i] == (uint8_t)expected[i];
+			if(expected[i] == ',')
+			{
+				numOfGood += good;
+				good = 1;
+			}
+		}
+	}
+	double divisions = (double)Print_divisions/PRINT_NUM_OF_NUMBERS;
+	printf("%-8s per number %5.1f steps in 32 bit, %5.1f in 16 bit, %4.1f divisions (%5.1f steps in 32 bit),"
+		" %u/%u numbers received unchanged\n",
+		way->name, (double)SWUART_printLongSteps/PRINT_NUM_OF_NUMBERS, (double)SWUART_printShortSteps/PRINT_NUM_OF_NUMBERS,
+		divisions, PRINT_DIVISION_STEPS*divisions, numOfGood, PRINT_NUM_OF_NUMBERS);
+	return numOfGood;
+}
+
+int main(void)
+{
+	uint32_t state = 0xACE1ACE1;
+	uint16_t errors = 0;
+	//32 bit Galois LFSR, shifted right by 0 to 31 bits so every number of digits comes up
+	for(uint16_t i = 0; i < PRINT_NUM_OF_NUMBERS; i++)
+	{
+		state = (state >> 1) ^ (-(state & 0x01) & 0xA3000000UL);
+		Print_numbers[i] = state >> (i % 32);
+	}
+	Sim_reset();
+	Sim_setCycleLimit(1000*(uint64_t)SYSTEM_CLK);
+	Sim_wire(UART_PORT, TX, UART_RX_PORT, RX);
+	SWUART_init(PRINT_BAUDRATE);
+	for(uint8_t i = 0; i < sizeof(Print_ways)/sizeof(Print_ways[0]); i++)
+	{
+		errors += PRINT_NUM_OF_NUMBERS - Print_run(&Print_ways[i]);
+	}
+	return errors != 0;
+}
+
+
+//////////////////////////////////////////////////////////
@@ -0,0 +1,255 @@
+//############# stats.c ##############
+/*
+ * Link statistics run of the SW UART driver on the simulator.
+ * A peer driven with Sim_drive on the RX pin of the default channel sends frames in the frame format of the driver,
+ * good ones and ones with a wrong parity bit, if the format has one, a low stop bit, short pulses in the data bits
+ * or a short low pulse on the idle line, and the channel sends bytes on its TX pin, which is left open.
+ * Build it like the loopback run in Sim.h with Simulator/stats.c instead of Simulator/loopback.c.
+ *
+ * Every case checks the status of the received frames and all the counters of ST_SWUART_stats_t it touches,
+ * the other counters must stay 0, and SWUART_resetStats must clear them all.
+ * It returns 0 if every frame had the expected status and every counter the expected value.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "SWUART.h"
+#include "Sim.h"
+
+#if SWUART_RX_MODE != SWUART_RX_MAJORITY_VOTE || SWUART_TICKS_PER_BIT != 3
+#error "the noise and the glitches are counted by the majority vote, build it with 3 SWUART_TICKS_PER_BIT"
+#endif
+
+#define STATS_BAUDRATE			9600
+#define STATS_BIT_CYCLES		(SYSTEM_CLK/STATS_BAUDRATE)
+#define STATS_NUM_OF_GOOD		10
+#define STATS_NUM_OF_SENT		20
+//frames sent after the receive buffer is full, it holds SWUART_RX_BUFFER_SIZE-1 frames
+#define STATS_NUM_OF_EXTRA		3
+#define STATS_NUM_OF_NOISY		4
+//what the peer puts in a frame
+#define STATS_FRAME_OK			0
+#define STATS_FRAME_PARITY		1
+#define STATS_FRAME_STOP		2
+#define STATS_FRAME_NOISE		3
+//the data bits from STATS_NOISE_BIT on get a pulse each, in the next quarter of the bit,
+//so one of them flips a middle sample at every phase of the ticks, the data bits around them have their level
+#define STATS_NOISE_DATA		SWUART_DATA_MASK
+#define STATS_NOISE_BIT			1
+
+static uint64_t Stats_globalBitEnd = 0;
+static uint16_t Stats_globalErrors = 0;
+
+static void Stats_runUntil(uint64_t cycle)
+{
+	while(Sim_cycles() < cycle)
+	{
+		Sim_run(1);
+	}
+}
+
+//drives one bit time of the peer, the bits are timed on the clock as Sim_run doesn't count the cycles of the ISRs
+static void Stats_bit(uint8_t level)
+{
+	Sim_drive(UART_RX_PORT, RX, level);
+	Stats_globalBitEnd += STATS_BIT_CYCLES;
+	Stats_runUntil(Stats_globalBitEnd);
+}
+
+//drives a bit with the other level for one quarter of it, shorter than a tick so it flips one sample at most
+static void Stats_noisyBit(uint8_t level, uint8_t quarter)
+{
+	uint64_t start = Stats_globalBitEnd;
+	Sim_drive(UART_RX_PORT, RX, level);
+	Stats_runUntil(start + quarter*STATS_BIT_CYCLES/4);
+	Sim_drive(UART_RX_PORT, RX, !level);
+	Stats_runUntil(start + (quarter+1)*STATS_BIT_CYCLES/4);
+	Sim_drive(UART_RX_PORT, RX, level);
+	Stats_globalBitEnd += STATS_BIT_CYCLES;
+	Stats_runUntil(Stats_globalBitEnd);
+}
+
+static void Stats_frame(SWUART_data_t data, uint8_t kind)
+{
+	uint8_t ones = 0;
+	Stats_bit(LOW);
+	for(uint8_t i = 0; i < SWUART_DATA_BITS; i++)
+	{
+#if SWUART_BIT_ORDER == SWUART_MSB_FIRST
+		uint8_t level = (data >> (SWUART_DATA_BITS-1-i)) & 0x01;
+#else
+		uint8_t level = (data >> i) & 0x01;
+#endif
+		ones += level;
+		if(kind == STATS_FRAME_NOISE && i >= STATS_NOISE_BIT && i < STATS_NOISE_BIT+4)
+		{
+			Stats_noisyBit(level, i - STATS_NOISE_BIT);
+		}
+		else
+		{
+			Stats_bit(level);
+		}
+	}
+	//a wrong parity bit is a parity error in every parity mode
+#if SWUART_PARITY == SWUART_PARITY_EVEN
+	Stats_bit((ones & 0x01) ^ (kind == STATS_FRAME_PARITY));
+#elif SWUART_PARITY == SWUART_PARITY_ODD
+	Stats_bit(!(ones & 0x01) ^ (kind == STATS_FRAME_PARITY));
+#elif SWUART_PARITY == SWUART_PARITY_MARK
+	Stats_bit(kind != STATS_FRAME_PARITY);
+#elif SWUART_PARITY == SWUART_PARITY_SPACE
+	Stats_bit(kind == STATS_FRAME_PARITY);
+#endif
+	(void)ones;
+	Stats_bit(kind != STATS_FRAME_STOP);
+	for(uint8_t i = 2+SWUART_DATA_BITS+SWUART_PARITY_BITS; i < SWUART_FRAME_BITS; i++)
+	{
+		Stats_bit(HIGH);
+	}
+	//the line is idle again before the next frame
+	Stats_bit(HIGH);
+}
+
+//receives the frames waiting and checks that all of them have the status
+static void Stats_expectFrames(const char *name, uint8_t numOfFrames, uint8_t status)
+{
+	SWUART_data_t data;
+	uint8_t frameStatus, numOfReceived = 0, good = 1;
+	printf("%s: received", name);
+	while(SWUART_channelTryReceiveStatus(SWUART_DEFAULT_CHANNEL, &data, &frameStatus) == SWUART_OK)
+	{
+		printf(" %02X/%02X", (unsigned)data, frameStatus);
+		good &= frameStatus == status;
+		numOfReceived++;
+	}
+	good &= numOfReceived == numOfFrames;
+	printf("%s\n", good ? "" : ", wrong");
+	if(!good)
+	{
+		Stats_globalErrors++;
+	}
+}
+
+//checks every counter against the expected ones
+static void Stats_expect(const char *name, const ST_SWUART_stats_t *expected)
+{
+	ST_SWUART_stats_t stats;
+	SWUART_getStats(&stats);
+	uint8_t good = stats.txFrames == expected->txFrames && stats.rxFrames == expected->rxFrames
+		&& stats.rxFramesOk == expected->rxFramesOk && stats.parityErrors == expected->parityErrors
+		&& stats.framingErrors == expected->framingErrors && stats.overruns == expected->overruns
+		&& stats.noisyFrames == expected->noisyFrames && stats.glitches == expected->glitches
+		&& stats.collisions == expected->collisions && stats.txDropped == expected->txDropped
+		&& stats.maxTxUsed == expected->maxTxUsed && stats.maxRxUsed == expected->maxRxUsed;
+	printf("%s: tx %lu, rx %lu, ok %lu, parity %u, framing %u, overruns %u, noisy %u, glitches %u, collisions %u, "
+		"dropped %u, tx used %u, rx used %u%s\n", name, (unsigned long)stats.txFrames, (unsigned long)stats.rxFrames,
+		(unsigned long)stats.rxFramesOk, stats.parityErrors, stats.framingErrors, stats.overruns, stats.noisyFrames,
+		stats.glitches, stats.collisions, stats.txDropped, stats.maxTxUsed, stats.maxRxUsed, good ? "" : ", wrong");
+	if(!good)
+	{
+		Stats_globalErrors++;
+	}
+}
+
+int main(void)
+{
+	ST_SWUART_stats_t expected;
+	memset(&expected, 0, sizeof(expected));
+
+	Sim_reset();
+	Sim_setCycleLimit(100*(uint64_t)SYSTEM_CLK);
+	SWUART_init(STATS_BAUDRATE);
+	Sim_run(1000);
+	Stats_globalBitEnd = Sim_cycles();
+	Stats_expect("opened", &expected);
+
+	//good frames, all read at the end
+	for(uint8_t i = 0; i < STATS_NUM_OF_GOOD; i++)
+	{
+		Stats_frame(0x30 + i, STATS_FRAME_OK);
+	}
+	Stats_expectFrames("good", STATS_NUM_OF_GOOD, SWUART_STATUS_OK);
+	expected.rxFrames = expected.rxFramesOk = expected.maxRxUsed = STATS_NUM_OF_GOOD;
+	Stats_expect("good", &expected);
+
+	//a frame of each error, read one by one
+#if SWUART_PARITY != SWUART_PARITY_NONE
+	Stats_frame(0x41, STATS_FRAME_PARITY);
+	Stats_expectFrames("parity", 1, SWUART_STATUS_PARITY_ERROR);
+	expected.rxFrames++;
+	expected.parityErrors++;
+#endif
+	Stats_frame(0x42, STATS_FRAME_STOP);
+	Stats_expectFrames("stop bit", 1, SWUART_STATUS_FRAMING_ERROR);
+	expected.rxFrames++;
+	expected.framingErrors++;
+	//the receiver is done with the frame in the middle of the low stop bit, at some phases of the ticks the rest of it
+	//is taken as a start bit that is high again in its middle
+	ST_SWUART_stats_t stats;
+	SWUART_getStats(&stats);
+	if(stats.glitches <= 1)
+	{
+		expected.glitches = stats.glitches;
+	}
+	Stats_expect("errors", &expected);
+
+	//the pulses don't change the data, the frames are kept with the noise flag
+	for(uint8_t i = 0; i < STATS_NUM_OF_NOISY; i++)
+	{
+		Stats_frame(STATS_NOISE_DATA, STATS_FRAME_NOISE);
+	}
+	Stats_expectFrames("noise", STATS_NUM_OF_NOISY, SWUART_STATUS_NOISE);
+	expected.rxFrames += STATS_NUM_OF_NOISY;
+	expected.rxFramesOk += STATS_NUM_OF_NOISY;
+	expected.noisyFrames += STATS_NUM_OF_NOISY;
+	Stats_expect("noise", &expected);
+
+	//a low pulse of a quarter bit on the idle line is no start bit
+	Sim_drive(UART_RX_PORT, RX, LOW);
+	Stats_runUntil(Stats_globalBitEnd + STATS_BIT_CYCLES/4);
+	Sim_drive(UART_RX_PORT, RX, HIGH);
+	Stats_globalBitEnd += 2*STATS_BIT_CYCLES;
+	Stats_runUntil(Stats_globalBitEnd);
+	Stats_expectFrames("glitch", 0, SWUART_STATUS_OK);
+	expected.glitches++;
+	Stats_expect("glitch", &expected);
+
+	//the frames after a full receive buffer are dropped, the next frame read carries the overrun
+	for(uint8_t i = 0; i < SWUART_RX_BUFFER_SIZE-1+STATS_NUM_OF_EXTRA; i++)
+	{
+		Stats_frame(i, STATS_FRAME_OK);
+	}
+	expected.rxFrames += SWUART_RX_BUFFER_SIZE-1+STATS_NUM_OF_EXTRA;
+	expected.rxFramesOk += SWUART_RX_BUFFER_SIZE-1+STATS_NUM_OF_EXTRA;
+	expected.overruns = STATS_NUM_OF_EXTRA;
+	expected.maxRxUsed = SWUART_RX_BUFFER_SIZE - 1;
+	Stats_expect("overrun", &expected);
+	SWUART_resetStats();
+	memset(&expected, 0, sizeof(expected));
+	Stats_expect("reset", &expected);
+	while(SWUART_available() != 0)
+	{
+		SWUART_read();
+	}
+	Stats_frame(0x55, STATS_FRAME_OK);
+	Stats_expectFrames("after the overrun", 1, SWUART_STATUS_OVERRUN);
+	expected.rxFrames = expected.rxFramesOk = expected.maxRxUsed = 1;
+	Stats_expect("after the overrun", &expected);
+
+	//the bytes are queued faster than they are sent
+	for(uint8_t i = 0; i < STATS_NUM_OF_SENT; i++)
+	{
+		SWUART_sendAsync(0x60 + i);
+	}
+	while(!SWUART_txIdle())
+	{
+		Sim_run(100);
+	}
+	expected.txFrames = STATS_NUM_OF_SENT;
+	expected.maxTxUsed = STATS_NUM_OF_SENT;
+	Stats_expect("sent", &expected);
+	printf("errors %u\n", Stats_globalErrors);
+	return Stats_globalErrors != 0;
+}
+
+
+//////////////////////////////////////////////////////////
@@ -0,0 +1,192 @@
+//############# timers.c ##############
+/*
+ * Timer service run on the simulator.
+ * One-shot and periodic software timers are started on the Timer 0 timebase alone, then with the SW UART bit clock
+ * as the client while a loopback line carries bytes, and the client is switched off by closing the channel
+ * while the timers are pending, with one of them already due.
+ * Build it like the loopback run in Sim.h with Simulator/timers.c instead of Simulator/loopback.c.
+ *
+ * Every callback checks that it is called with the interrupts disabled, not before its deadline and not later than
+ * the latency of its match: a few ticks on the timebase, one client tick more while the client checks the deadlines.
+ * At the end of every part no deadline may be left behind without its call.
+ * It returns 0 if every call came in time with the interrupts disabled.
+ */
+#include <stdio.h>
+#include "../MCAL/Interrupt/Interrupt.h"
+#include "TimerService.h"
+#include "SWUART.h"
+#include "Sim.h"
+
+#define TIMERS_BAUDRATE			9600
+#define TIMERS_NUM_OF_BYTES		10
+//ticks from a deadline to its call on the timebase, the match and the ISR entry take a few ticks of 8 cycles
+#define TIMERS_LATENCY			8
+//ticks of every part
+#define TIMERS_RUN_TICKS		20000
+//bit 7 of SREG is the global interrupt flag
+#define TIMERS_I_BIT			7
+
+static uint32_t Timers_globalDeadline[TIMER_SERVICE_NUM_OF_TIMERS];
+static uint32_t Timers_globalPeriod[TIMER_SERVICE_NUM_OF_TIMERS];
+static uint16_t Timers_globalCalls[TIMER_SERVICE_NUM_OF_TIMERS];
+static uint32_t Timers_globalMaxLate[TIMER_SERVICE_NUM_OF_TIMERS];
+//deadlines up to this tick may be late by a client tick, the later ones only by the timebase latency
+static uint32_t Timers_globalClientUntil = 0;
+static uint32_t Timers_globalClientLatency = 0;
+static uint16_t Timers_globalErrors = 0;
+
+static void Timers_check(uint8_t timer)
+{
+	uint32_t now = Timer0_getTicks();
+	uint32_t deadline = Timers_globalDeadline[timer];
+	uint32_t latency = (sint32_t)(deadline - Timers_globalClientUntil) <= 0 ? Timers_globalClientLatency : TIMERS_LATENCY;
+	uint32_t late = now - deadline;
+	if(getBit(SREG,TIMERS_I_BIT))
+	{
+		printf("timer %u called with the interrupts enabled\n", timer);
+		Timers_globalErrors++;
+	}
+	if((sint32_t)late < 0 || late > latency)
+	{
+		printf("timer %u called %ld ticks after its deadline %lu\n", timer, (long)(sint32_t)late, (unsigned long)deadline);
+		Timers_globalErrors++;
+	}
+	else if(late > Timers_globalMaxLate[timer])
+	{
+		Timers_globalMaxLate[timer] = late;
+	}
+	Timers_globalCalls[timer]++;
+	Timers_globalDeadline[timer] += Timers_globalPeriod[timer];
+}
+
+static void Timers_callback0(void) { Timers_check(0); }
+static void Timers_callback1(void) { Timers_check(1); }
+static void Timers_callback2(void) { Timers_check(2); }
+static void Timers_callback3(void) { Timers_check(3); }
+
+static const TimerService_callback_t Timers_callbacks[TIMER_SERVICE_NUM_OF_TIMERS] =
+{
+	Timers_callback0, Timers_callback1, Timers_callback2, Timers_callback3
+};
+
+//the service reads the ticks after this, so the expected deadline is never later than its own
+static void Timers_start(uint8_t timer, uint32_t ticks, uint32_t periodTicks)
+{
+	Timers_globalDeadline[timer] = Timer0_now() + ticks;
+	Timers_globalPeriod[timer] = periodTicks;
+	Timers_globalCalls[timer] = 0;
+	Timers_globalMaxLate[timer] = 0;
+	if(TimerService_start(timer, ticks, periodTicks, Timers_callbacks[timer]) != TIMER_SERVICE_OK)
+	{
+		printf("timer %u not started\n", timer);
+		Timers_globalErrors++;
+	}
+}
+
+//runs the main loop for some ticks, then checks that no running timer missed a deadline
+static void Timers_run(const char *part, uint32_t ticks)
+{
+	Sim_run(ticks*Timer0_getPrescaler());
+	uint32_t now = Timer0_now();
+	printf("%s:", part);
+	for(uint8_t timer = 0; timer < TIMER_SERVICE_NUM_OF_TIMERS; timer++)
+	{
+		uint8_t running = TimerService_isRunning(timer);
+		if((running || Timers_globalCalls[timer] == 0) && (sint32_t)(now - Timers_globalDeadline[timer]) > (sint32_t)Timers_globalClientLatency)
+		{
+			printf(" timer %u missed its deadline %lu at %lu\n", timer, (unsigned long)Timers_globalDeadline[timer], (unsigned long)now);
+			Timers_globalErrors++;
+		}
+		printf(" timer %u %u calls late %lu,", timer, Timers_globalCalls[timer], (unsigned long)Timers_globalMaxLate[timer]);
+	}
+	printf(" errors %u\n", Timers_globalErrors);
+}
+
+static void Timers_timebase(void)
+{
+	Sim_reset();
+	Sim_setCycleLimit(10*(uint64_t)SYSTEM_CLK);
+	TimerService_init(clkI_DIVISION_BY_8);
+	sei();
+	Timers_globalClientUntil = 0;
+	Timers_globalClientLatency = TIMERS_LATENCY;
+	Timers_start(0, 1000, 0);
+	Timers_start(1, 300, 300);
+	Timers_start(2, 50, 1000);
+	//longer than a counter period, so the match comes after wraps of the counter
+	Timers_start(3, 5000, 0);
+	Timers_run("timebase", TIMERS_RUN_TICKS);
+	TimerService_stop(1);
+	TimerService_stop(2);
+}
+
+static void Timers_client(void)
+{
+	uint8_t numOfSent = 0, numOfReceived = 0;
+	SWUART_data_t data;
+
+	Sim_reset();
+	Sim_setCycleLimit(10*(uint64_t)SYSTEM_CLK);
+	Sim_wire(A, 0, A, 1);
+	SWUART_open(0, A, 0, 1, TIMERS_BAUDRATE);
+	//the client keeps its prescaler, its matches check the deadlines once a tick
+	TimerService_init(clkI_DIVISION_BY_8);
+	Timers_globalClientUntil = 0xFFFFFFFF/2;
+	Timers_globalClientLatency = Timer0_getClock()/((uint32_t)Timer0_getPrescaler()*TIMERS_BAUDRATE*SWUART_TICKS_PER_BIT) + 1 + TIMERS_LATENCY;
+	Timers_start(0, 1000, 0);
+	Timers_start(1, 300, 300);
+	Timers_start(2, 50, 1000);
+	Timers_start(3, 5000, 0);
+	//the bytes go out while the timers are called from the same compare match
+	uint32_t end = Timer0_now() + TIMERS_RUN_TICKS;
+	while((sint32_t)(Timer0_now() - end) < 0)
+	{
+		if(numOfSent < TIMERS_NUM_OF_BYTES && SWUART_channelTxFree(0) != 0)
+		{
+			SWUART_channelSendAsync(0, 0x30 + numOfSent++);
+		}
+		if(SWUART_channelTryReceive(0, &data) == SWUART_OK)
+		{
+			if(data != 0x30 + numOfReceived)
+			{
+				printf("client: byte %u received as %02X\n", numOfReceived, (unsigned)data);
+				Timers_globalErrors++;
+			}
+			numOfReceived++;
+		}
+		Sim_run(32);
+	}
+	if(numOfReceived != TIMERS_NUM_OF_BYTES)
+	{
+		printf("client: %u of %u bytes received\n", numOfReceived, TIMERS_NUM_OF_BYTES);
+		Timers_globalErrors++;
+	}
+	Timers_run("client", 0);
+
+	//timer 3 is due when the client stops, the dispatch of TimerService_setClient calls it at the latest
+	Timers_globalClientUntil = Timer0_now() + Timers_globalClientLatency;
+	Timers_start(0, 1000, 0);
+	Timers_start(3, 0, 0);
+	SWUART_close(0);
+	if(!getBit(SREG,TIMERS_I_BIT))
+	{
+		printf("client off: the interrupts are left disabled\n");
+		Timers_globalErrors++;
+	}
+	if(Timers_globalCalls[3] != 1)
+	{
+		printf("client off: the due timer isn't called\n");
+		Timers_globalErrors++;
+	}
+	Timers_run("client off", TIMERS_RUN_TICKS);
+}
+
+int main(void)
+{
+	Timers_timebase();
+	Timers_client();
+	return Timers_globalErrors != 0;
+}
+
+
+//////////////////////////////////////////////////////////
@@ -8,11 +8,14 @@
 int main()
 {
 	SWUART_init(9600);
-	uint8_t data = 0;
+	SWUART_data_t data = 0;
 	while(1)
 	{
-		SWUART_recieve(&data);
-		SWUART_send(data);
+		//echo without blocking, so the loop is free for other work while the line is silent
+		if(SWUART_tryReceive(&data) == SWUART_OK)
+		{
+			SWUART_send(data);
+		}
 	}
 	
 	